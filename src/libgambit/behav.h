@@ -23,10 +23,13 @@
 #ifndef LIBGAMBIT_BEHAV_H
 #define LIBGAMBIT_BEHAV_H
 
+#include <vector>
 #include "game.h"
 
 namespace Gambit {
 
+class GameTreeFlatView;
+
 ///
 /// MixedBehavProfile<T> implements a randomized behavior profile on
 /// an extensive game.
@@ -48,6 +51,10 @@ protected:
   mutable DVector<T> m_actionValues;   // aka conditional payoffs
   mutable DVector<T> m_gripe;
 
+  // scratch space for evaluating over the flattened tree, indexed
+  // globally; kept between computations to avoid reallocation
+  mutable std::vector<T> m_actionProbs, m_infosetProbs;
+
   const T &ActionValue(const GameAction &act) const 
     { return m_actionValues(act->GetInfoset()->GetPlayer()->GetNumber(),
 			    act->GetInfoset()->GetNumber(),
@@ -59,10 +66,8 @@ protected:
   
   /// @name Auxiliary functions for computation of interesting values
   //@{
-  void GetPayoff(GameTreeNodeRep *, const T &, int, T &) const;
-  
-  void ComputeSolutionDataPass2(const GameNode &node) const;
-  void ComputeSolutionDataPass1(const GameNode &node) const;
+  /// Fills m_actionProbs with the probability of each action in the tree
+  void ComputeActionProbs(const GameTreeFlatView &) const;
   void ComputeSolutionData(void) const;
   //@}
 
@@ -35,6 +35,7 @@ namespace Gambit {
 /// computational approaches that enumerate possible equilibrium
 /// supports.
 class BehavSupport {
+  template <class T> friend class MixedBehavProfile;
 protected:
   Game m_efg;
   Array<Array<Array<GameAction> > > m_actions;
@@ -0,0 +1,235 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/binfile.cc
+// Storing numbers in binary game files
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <climits>
+#include "libgambit.h"
+#include "binfile.h"
+
+namespace Gambit {
+
+namespace {
+
+/// The most digits after the point of a decimal stored in binary, and
+/// the most digits in a number written in binary on this host, so that
+/// its parts fit in 64 bits, or in a long if that is shorter
+const int c_maxPlaces = 18;
+const int c_maxDigits = (LONG_MAX > 0x7fffffffL) ? c_maxPlaces : 9;
+
+/// Returns the text of an integer
+std::string IntegerText(const Integer &p_value)
+{
+  if (!p_value.fits_in_long()) {
+    return Itoa(p_value);
+  }
+  long value = p_value.as_long();
+  unsigned long magnitude = (value < 0) ? -(unsigned long) value : (unsigned long) value;
+  char digits[24], *c = digits + sizeof(digits);
+  do {
+    *--c = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+  if (value < 0) {
+    *--c = '-';
+  }
+  return std::string(c, digits + sizeof(digits) - c);
+}
+
+/// Returns the text of the decimal with the given digits, of which
+/// p_places follow the point
+std::string DecimalText(const Integer &p_digits, int p_places)
+{
+  Integer magnitude(p_digits);
+  magnitude.abs();
+  std::string text = IntegerText(magnitude);
+  if (static_cast<int>(text.length()) <= p_places) {
+    text.insert(0, p_places + 1 - text.length(), '0');
+  }
+  text.insert(text.length() - p_places, 1, '.');
+  if (sign(p_digits) < 0) {
+    text.insert(0, 1, '-');
+  }
+  return text;
+}
+
+/// Parses a run of digits, returning their number, and accumulating the
+/// first c_maxDigits of them in p_value
+int ParseDigits(const char *&p_text, unsigned long &p_value)
+{
+  int digits = 0;
+  for (; *p_text >= '0' && *p_text <= '9'; p_text++, digits++) {
+    if (digits < c_maxDigits) {
+      p_value = 10 * p_value + (*p_text - '0');
+    }
+  }
+  return digits;
+}
+
+//
+// Finds the binary form of a number from its text, setting p_first and
+// p_second to the parts stored for it.  Returns c_binaryText if the text
+// is not an integer, fraction or decimal of at most c_maxDigits digits.
+//
+BinaryNumberForm ParseNumber(const std::string &p_text,
+			     long &p_first, long &p_second)
+{
+  const char *c = p_text.c_str();
+  bool negative = (*c == '-');
+  if (negative)  c++;
+  unsigned long value = 0;
+  int digits = ParseDigits(c, value);
+  if (digits == 0 || digits > c_maxDigits) {
+    return c_binaryText;
+  }
+
+  BinaryNumberForm form = c_binaryInteger;
+  if (*c == '/') {
+    unsigned long den = 0;
+    int denDigits = ParseDigits(++c, den);
+    if (denDigits == 0 || denDigits > c_maxDigits || den == 0) {
+      return c_binaryText;
+    }
+    form = c_binaryFraction;
+    p_second = static_cast<long>(den);
+  }
+  else if (*c == '.') {
+    int places = ParseDigits(++c, value);
+    if (places == 0 || digits + places > c_maxDigits) {
+      return c_binaryText;
+    }
+    form = c_binaryDecimal;
+    p_second = places;
+  }
+  if (*c != '\0') {
+    return c_binaryText;
+  }
+  p_first = (negative) ? -static_cast<long>(value) : static_cast<long>(value);
+  return form;
+}
+
+}  // end anonymous namespace
+
+//========================================================================
+//                       class BinaryGameWriter
+//========================================================================
+
+void BinaryGameWriter::WriteNumbers(void)
+{
+  WriteInt(m_numbers.size());
+  for (size_t i = 0; i < m_numbers.size(); i++) {
+    const std::string &text = m_numbers[i];
+    long first = 0, second = 0;
+    BinaryNumberForm form = ParseNumber(text, first, second);
+    // A number is stored in binary only if its text is rebuilt exactly
+    switch (form) {
+    case c_binaryInteger:
+      if (IntegerText(first) != text)  form = c_binaryText;
+      break;
+    case c_binaryFraction:
+      if (IntegerText(first) + "/" + IntegerText(second) != text) {
+	form = c_binaryText;
+      }
+      break;
+    case c_binaryDecimal:
+      if (DecimalText(first, second) != text)  form = c_binaryText;
+      break;
+    default:
+      break;
+    }
+
+    WriteInt(form);
+    if (form == c_binaryText) {
+      WriteString(text);
+      continue;
+    }
+    WriteLong(first);
+    if (form == c_binaryFraction) {
+      WriteLong(second);
+    }
+    else if (form == c_binaryDecimal) {
+      WriteInt(second);
+    }
+  }
+}
+
+//========================================================================
+//                       class BinaryGameReader
+//========================================================================
+
+Integer BinaryGameReader::ReadInteger(void)
+{
+  unsigned int low = ReadInt(), high = ReadInt();
+  if ((high == 0 && low <= 0x7fffffffU) ||
+      (high == 0xffffffffU && low >= 0x80000000U)) {
+    return Integer(static_cast<long>(static_cast<int>(low)));
+  }
+  Integer value(static_cast<long>(static_cast<int>(high)));
+  value <<= 32;
+  value += Integer(static_cast<unsigned long>(low));
+  return value;
+}
+
+Number BinaryGameReader::ReadValue(void)
+{
+  switch (ReadInt()) {
+  case c_binaryText:
+    try {
+      return Number(ReadString());
+    }
+    catch (ValueException &) {
+      throw InvalidFileException("Invalid number in binary game file");
+    }
+  case c_binaryInteger: {
+    Integer value = ReadInteger();
+    return Number(IntegerText(value), Rational(value));
+  }
+  case c_binaryFraction: {
+    Integer num = ReadInteger(), den = ReadInteger();
+    if (sign(den) <= 0) {
+      throw InvalidFileException("Invalid number in binary game file");
+    }
+    return Number(IntegerText(num) + "/" + IntegerText(den), Rational(num, den));
+  }
+  case c_binaryDecimal: {
+    Integer digits = ReadInteger();
+    int places = ReadInt(1, c_maxPlaces);
+    Integer den(1L);
+    for (int i = 0; i < places; i++) {
+      den *= 10L;
+    }
+    return Number(DecimalText(digits, places), Rational(digits, den));
+  }
+  default:
+    throw InvalidFileException("Invalid number in binary game file");
+  }
+}
+
+void BinaryGameReader::ReadNumbers(void)
+{
+  // Each number is at least its form and one 32-bit field
+  int count = ReadCount(0, 1 << 30, 8);
+  m_numbers.reserve(count);
+  for (int i = 0; i < count; i++) {
+    m_numbers.push_back(ReadValue());
+  }
+}
+
+}  // end namespace Gambit
@@ -0,0 +1,223 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/binfile.h
+// Primitives for reading and writing binary game files
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_BINFILE_H
+#define LIBGAMBIT_BINFILE_H
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include "game.h"
+
+namespace Gambit {
+
+//
+// Binary game files begin with a text line naming the representation,
+// "#NFGBIN" for strategic games and "#EFGBIN" for extensive games, so
+// ReadGame() can recognize them from the first token.  The rest of the
+// file is a sequence of unsigned 32-bit integers, stored little-endian
+// regardless of the host, and strings, stored as their length followed
+// by their bytes.
+//
+// Payoffs and probabilities are kept in a table of the distinct numbers
+// in the game, which precedes the outcomes, and each payoff or
+// probability is stored as its zero-based index in the table.  Each
+// number in the table is stored as a form, followed by the value in that
+// form.  Integers, fractions and decimals of up to 18 digits are stored
+// as 64-bit integers, as two 32-bit integers with the low half first: an
+// integer as its value, a fraction as its numerator and denominator, and
+// a decimal as the integer given by its digits followed by the number of
+// digits after the point.  Any other number is stored as its text.  A
+// number is stored in binary only if its text is written exactly as it
+// would be rebuilt from the binary form, so converting between text and
+// binary files is exact in both directions.
+//
+
+/// The version of the binary format written by this library
+const unsigned int c_binaryFileVersion = 2;
+
+/// The forms in which a number is stored in a binary game file
+enum BinaryNumberForm {
+  c_binaryText = 0, c_binaryInteger = 1,
+  c_binaryFraction = 2, c_binaryDecimal = 3
+};
+
+/// Writes the primitive fields of a binary game file
+class BinaryGameWriter {
+private:
+  std::ostream &m_stream;
+  std::map<std::string, int> m_index;
+  std::vector<std::string> m_numbers;
+
+  void WriteLong(long p_value)
+  {
+    WriteInt(static_cast<unsigned int>(p_value));
+    // Shifted in two steps, as a long may have only 32 bits
+    WriteInt(static_cast<unsigned int>((p_value >> 16) >> 16));
+  }
+
+public:
+  /// Writes the header line and format version to the stream
+  BinaryGameWriter(std::ostream &p_stream, const char *p_magic)
+    : m_stream(p_stream)
+  {
+    m_stream << p_magic << '\n';
+    WriteInt(c_binaryFileVersion);
+  }
+
+  void WriteInt(unsigned int p_value)
+  {
+    char bytes[4];
+    for (int i = 0; i < 4; i++) {
+      bytes[i] = static_cast<char>((p_value >> (8 * i)) & 0xff);
+    }
+    m_stream.write(bytes, 4);
+  }
+
+  void WriteString(const std::string &p_value)
+  {
+    WriteInt(p_value.length());
+    m_stream.write(p_value.data(), p_value.length());
+  }
+
+  /// Adds a number to the table of numbers.  All numbers must be added
+  /// before the table is written.
+  void AddNumber(const Number &p_value)
+  {
+    const std::string &text = p_value;
+    if (m_index.insert(std::make_pair(text, m_numbers.size())).second) {
+      m_numbers.push_back(text);
+    }
+  }
+
+  /// Writes the table of numbers, each in binary if its text allows
+  void WriteNumbers(void);
+
+  /// Writes a number, as its index in the table
+  void WriteNumber(const Number &p_value)
+  { WriteInt(m_index.find(p_value)->second); }
+};
+
+/// Reads the primitive fields of a binary game file
+///
+/// The remainder of the stream is read into memory in large blocks when
+/// the reader is constructed, and fields are then decoded directly from
+/// the buffer, so the cost of loading a game does not depend on the
+/// per-call overhead of the stream.
+class BinaryGameReader {
+private:
+  std::string m_buffer;
+  const char *m_next, *m_end;
+  std::vector<Number> m_numbers;
+
+  Integer ReadInteger(void);
+  Number ReadValue(void);
+
+public:
+  /// Reads the stream and checks the format version.  The caller is
+  /// responsible for having consumed the header line.
+  BinaryGameReader(std::istream &p_stream)
+  {
+    std::streambuf *buffer = p_stream.rdbuf();
+    char block[1 << 16];
+    std::streamsize count;
+    while ((count = buffer->sgetn(block, sizeof(block))) > 0) {
+      m_buffer.append(block, count);
+    }
+    m_next = m_buffer.data();
+    m_end = m_next + m_buffer.length();
+
+    if (ReadInt() != c_binaryFileVersion) {
+      throw InvalidFileException("Unsupported version of binary game file");
+    }
+  }
+
+  /// Checks that at least p_bytes remain to be read
+  void Require(size_t p_bytes) const
+  {
+    if (static_cast<size_t>(m_end - m_next) < p_bytes) {
+      throw InvalidFileException("End of file encountered in binary game file");
+    }
+  }
+
+  unsigned int ReadInt(void)
+  {
+    Require(4);
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(m_next);
+    m_next += 4;
+    return (static_cast<unsigned int>(bytes[0]) |
+	    static_cast<unsigned int>(bytes[1]) << 8 |
+	    static_cast<unsigned int>(bytes[2]) << 16 |
+	    static_cast<unsigned int>(bytes[3]) << 24);
+  }
+
+  /// Reads an integer, which must lie in the range [p_min, p_max]
+  int ReadInt(int p_min, int p_max)
+  {
+    unsigned int value = ReadInt();
+    if (value < static_cast<unsigned int>(p_min) ||
+	value > static_cast<unsigned int>(p_max)) {
+      throw InvalidFileException("Value out of range in binary game file");
+    }
+    return static_cast<int>(value);
+  }
+
+  /// Reads the number of records which follow, which must lie in the
+  /// range [p_min, p_max].  Each record takes at least p_size bytes, and
+  /// the count is checked against what remains, so that a corrupt count
+  /// is reported before any storage is allocated for the records.
+  int ReadCount(int p_min, int p_max, size_t p_size)
+  {
+    int count = ReadInt(p_min, p_max);
+    if (p_size > 0 && 
+	static_cast<size_t>(count) > static_cast<size_t>(m_end - m_next) / p_size) {
+      throw InvalidFileException("End of file encountered in binary game file");
+    }
+    return count;
+  }
+
+  std::string ReadString(void)
+  {
+    size_t length = ReadInt();
+    Require(length);
+    std::string value(m_next, length);
+    m_next += length;
+    return value;
+  }
+
+  /// Reads the table of numbers
+  void ReadNumbers(void);
+
+  /// Reads a number, as its index in the table
+  const Number &ReadNumber(void)
+  {
+    if (m_numbers.empty()) {
+      throw InvalidFileException("Value out of range in binary game file");
+    }
+    return m_numbers[ReadInt(0, m_numbers.size() - 1)];
+  }
+};
+
+}  // end namespace Gambit
+
+#endif  // LIBGAMBIT_BINFILE_H
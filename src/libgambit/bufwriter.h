@@ -0,0 +1,144 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/bufwriter.h
+// Buffered formatting of large text game files
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_BUFWRITER_H
+#define LIBGAMBIT_BUFWRITER_H
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "rational.h"
+
+namespace Gambit {
+
+/// \brief Formats text into a large buffer, writing it out in blocks
+///
+/// Writing the body of a large game file through the formatted output
+/// operators of std::ostream costs a virtual call and a locale lookup
+/// per number.  This class collects the text in a large buffer,
+/// which is passed to the stream only when full, and formats integers
+/// and rationals whose parts fit in a long directly.  The output is the
+/// same as that of the stream operators.
+class BufferedWriter {
+private:
+  enum { c_bufferSize = 1 << 16 };
+
+  std::ostream &m_stream;
+  std::vector<char> m_buffer;
+  size_t m_used;
+
+  /// @name Copying is not permitted
+  //@{
+  BufferedWriter(const BufferedWriter &);
+  BufferedWriter &operator=(const BufferedWriter &);
+  //@}
+
+public:
+  /// @name Lifecycle
+  //@{
+  BufferedWriter(std::ostream &p_stream)
+    : m_stream(p_stream), m_buffer(c_bufferSize), m_used(0) { }
+  ~BufferedWriter() { Flush(); }
+  //@}
+
+  /// Passes any buffered text to the stream
+  void Flush(void)
+  {
+    if (m_used > 0) {
+      m_stream.write(&m_buffer[0], m_used);
+      m_used = 0;
+    }
+  }
+
+  /// @name Formatting
+  //@{
+  BufferedWriter &operator<<(char p_value)
+  {
+    if (m_used == c_bufferSize) {
+      Flush();
+    }
+    m_buffer[m_used++] = p_value;
+    return *this;
+  }
+
+  BufferedWriter &operator<<(const char *p_value)
+  { Write(p_value, strlen(p_value)); return *this; }
+
+  BufferedWriter &operator<<(const std::string &p_value)
+  { Write(p_value.data(), p_value.length()); return *this; }
+
+  BufferedWriter &operator<<(long p_value)
+  {
+    // Digits are generated from the least significant end
+    char digits[24];
+    char *end = digits + sizeof(digits), *c = end;
+    unsigned long magnitude = (p_value < 0) ?
+      -(unsigned long) p_value : (unsigned long) p_value;
+    do {
+      *--c = (char) ('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude > 0);
+    if (p_value < 0) {
+      *--c = '-';
+    }
+    Write(c, end - c);
+    return *this;
+  }
+
+  BufferedWriter &operator<<(int p_value)
+  { return *this << (long) p_value; }
+
+  BufferedWriter &operator<<(const Rational &p_value)
+  {
+    const Integer &num = p_value.numerator(), &den = p_value.denominator();
+    if (num.fits_in_long() && den.fits_in_long()) {
+      *this << num.as_long();
+      if (den.as_long() != 1) {
+	*this << '/' << den.as_long();
+      }
+    }
+    else {
+      *this << lexical_cast<std::string>(p_value);
+    }
+    return *this;
+  }
+  //@}
+
+  /// Appends a block of text
+  void Write(const char *p_text, size_t p_length)
+  {
+    if (p_length > c_bufferSize - m_used) {
+      Flush();
+      if (p_length > c_bufferSize) {
+	m_stream.write(p_text, p_length);
+	return;
+      }
+    }
+    memcpy(&m_buffer[m_used], p_text, p_length);
+    m_used += p_length;
+  }
+};
+
+}  // end namespace Gambit
+
+#endif  // LIBGAMBIT_BUFWRITER_H
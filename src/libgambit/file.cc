@@ -20,6 +20,7 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <cstdio>
 #include <cstdlib>
 #include <cctype>
 #include <iostream>
@@ -27,6 +28,8 @@
 #include <map>
 
 #include "libgambit.h"
+#include "gametable.h"
+#include "gametree.h"
 
 namespace {
 // This anonymous namespace encapsulates the file-parsing code
@@ -43,22 +46,41 @@ typedef enum {
 //! including the nonsignificance of whitespace and the possibility of
 //! escaped-quotes within text labels.
 //!
+//! Characters are taken directly from the buffer of the stream, which
+//! reads the file in blocks, rather than through the formatted input
+//! functions of the stream.  The stream is left positioned immediately
+//! after the last character consumed, so that readers for other
+//! formats can continue from it.  The text of each token is built in
+//! place in a single string, whose storage is reused between tokens.
+//!
 class GameParserState {
 private:
-  std::istream &m_file;
+  std::streambuf *m_buffer;
 
   int m_currentLine;
   int m_currentColumn;
   GameFileToken m_lastToken;
   std::string m_lastText;
 
-  void ReadChar(char& c);
-  void UnreadChar(void);
+  /// Consumes and returns the next character, or EOF at end of input
+  int ReadChar(void)
+  { 
+    int c = m_buffer->sbumpc();
+    m_currentColumn++;
+    return c;
+  }
+  /// Returns the next character without consuming it, or EOF
+  int PeekChar(void) const { return m_buffer->sgetc(); }
+  /// Appends the following run of digits to the token text
+  void ReadDigits(void);
+  /// Appends an exponent, starting at the 'e' or 'E', to the token text
+  void ReadExponent(void);
   void IncreaseLine(void);
 
 public:
   GameParserState(std::istream &p_file) :
-    m_file(p_file), m_currentLine(1), m_currentColumn(1) { }
+    m_buffer(p_file.rdbuf()), m_currentLine(1), m_currentColumn(1),
+    m_lastToken(TOKEN_EOF) { }
 
   GameFileToken GetNextToken(void);
   GameFileToken GetCurrentToken(void) const { return m_lastToken; }
@@ -68,40 +90,41 @@ public:
   const std::string &GetLastText(void) const { return m_lastText; }
 };
 
-void GameParserState::ReadChar(char& c)
-{
-  m_file.get(c);
-  m_currentColumn++;
-}
-
-void GameParserState::UnreadChar(void)
-{
-  m_file.unget();
-  m_currentColumn--;
-}
-
 void GameParserState::IncreaseLine(void){
   m_currentLine++;
   // Reset column
   m_currentColumn = 1;
 }
 
-GameFileToken GameParserState::GetNextToken(void)
+void GameParserState::ReadDigits(void)
 {
-  char c = ' ';
-  if (m_file.eof()) {
-    return (m_lastToken = TOKEN_EOF);
+  while (isdigit(PeekChar())) {
+    m_lastText += (char) ReadChar();
   }
+}
 
-  while (isspace(c)) {
-    ReadChar(c);
-    if (!m_file.good()) {
+void GameParserState::ReadExponent(void)
+{
+  m_lastText += (char) ReadChar();
+  // The character following the 'e' is the sign or the first digit
+  if (PeekChar() != EOF) {
+    m_lastText += (char) ReadChar();
+  }
+  ReadDigits();
+}
+
+GameFileToken GameParserState::GetNextToken(void)
+{
+  int c;
+  do {
+    c = ReadChar();
+    if (c == EOF) {
       return (m_lastToken = TOKEN_EOF);
     }
     else if (c == '\n') {
       IncreaseLine();
     }
-  }
+  } while (isspace(c));
 
   if (c == '{') {
     return (m_lastToken = TOKEN_LBRACE);
@@ -113,151 +136,68 @@ GameFileToken GameParserState::GetNextToken(void)
     return (m_lastToken = TOKEN_COMMA);
   }
   else if (isdigit(c) || c == '-' || c == '+') {
-    std::string buf;
-    buf += c;
-    ReadChar(c);
-
-    while (!m_file.eof() && m_file.good() && isdigit(c)) {
-      buf += c;
-      ReadChar(c);
-    }
-
-    if (m_file.eof() || !m_file.good()) {
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
-    }
+    m_lastText.assign(1, (char) c);
+    ReadDigits();
 
+    c = PeekChar();
     if (c == '.') {
-      buf += c;
-      ReadChar(c);
-      while (isdigit(c)) {
-        buf += c;
-        ReadChar(c);
-      }
-
+      m_lastText += (char) ReadChar();
+      ReadDigits();
+      c = PeekChar();
       if (c == 'e' || c == 'E') {
-        buf += c;
-        ReadChar(c);
-        if (c == '+' && c == '-' && !isdigit(c)) {
-          throw InvalidFileException(CreateLineMsg("Invalid Token +/-"));
-        }
-        buf += c;
-        ReadChar(c);
-        while (isdigit(c)) {
-          buf += c;
-          ReadChar(c);
-        }
+	ReadExponent();
       }
-
-      UnreadChar();
-      m_lastText = buf;
-
-      return (m_lastToken = TOKEN_NUMBER);
     }
     else if (c == '/') {
-      buf += c;
-      ReadChar(c);
-      while (isdigit(c)) {
-        buf += c;
-        ReadChar(c);
-      }
-      UnreadChar();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
+      m_lastText += (char) ReadChar();
+      ReadDigits();
     }
     else if (c == 'e' || c == 'E') {
-      buf += c;
-      ReadChar(c);
-      if (c == '+' && c == '-' && !isdigit(c)) {
-        throw InvalidFileException(CreateLineMsg("Invalid Token +/-"));
-      }
-      buf += c;
-      ReadChar(c);
-      while (isdigit(c)) {
-        buf += c;
-        ReadChar(c);
-      }
-      UnreadChar();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
-    }
-    else {
-      UnreadChar();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
+      ReadExponent();
     }
+    return (m_lastToken = TOKEN_NUMBER);
   }
   else if (c == '.') {
-    std::string buf;
-    buf += c;
-    ReadChar(c);
-
-    while (isdigit(c)) {
-      buf += c;
-      ReadChar(c);
-    }
-    UnreadChar();
-    m_lastText = buf;
+    m_lastText.assign(1, (char) c);
+    ReadDigits();
     return (m_lastToken = TOKEN_NUMBER);
   }
-
   else if (c == '"') {
     // We need to do a little magic here, since escaped quotes inside
     // the string are treated as quotes (not end-of-string)
-    UnreadChar();
-    char a;
+    m_lastText.clear();
+    bool lastslash = false;
 
-    m_lastText = "";
-
-    do  {
-      ReadChar(a);
-      if (a == '\n') {
-        IncreaseLine();
+    int a = ReadChar();
+    while (a != '"' || lastslash) {
+      if (a == EOF) {
+	throw InvalidFileException(CreateLineMsg("End of file encountered when reading string label"));
       }
-    } while (isspace(a));
-
-    if (a == '\"')  {
-      bool lastslash = false;
-
-      ReadChar(a);
-      while  (a != '\"' || lastslash)  {
-	if (m_file.eof() || !m_file.good())  {
-	  throw InvalidFileException(CreateLineMsg("End of file encountered when reading string label"));
-	}
-        if (lastslash && a == '"') {
-          m_lastText += '"';
-	}
-        else if (lastslash)  {
-          m_lastText += '\\';
-          m_lastText += a;
-        }
-        else if (a != '\\')
-          m_lastText += a;
-
-        lastslash = (a == '\\');
-        ReadChar(a);
+      if (lastslash && a == '"') {
+	m_lastText += '"';
       }
-    }
-    else  {
-      do  {
-      	m_lastText += a;
-        ReadChar(a);
-	if (m_file.eof() || !m_file.good())  {
-	  throw InvalidFileException(CreateLineMsg("End of file encountered when reading string label"));
-	}
-        if (a == '\n') {
-          IncreaseLine();
-        }
-      }  while (!isspace(a));
+      else if (lastslash) {
+	m_lastText += '\\';
+	m_lastText += (char) a;
+      }
+      else if (a != '\\') {
+	m_lastText += (char) a;
+      }
+
+      lastslash = (a == '\\');
+      a = ReadChar();
     }
 
     return (m_lastToken = TOKEN_TEXT);
   }
 
-  m_lastText = "";
-  while (!isspace(c) && !m_file.eof()) {
-    m_lastText += c;
-    ReadChar(c);
+  m_lastText.clear();
+  while (c != EOF && !isspace(c)) {
+    m_lastText += (char) c;
+    c = ReadChar();
+  }
+  if (c == '\n') {
+    IncreaseLine();
   }
   return (m_lastToken = TOKEN_SYMBOL);
 }
@@ -576,7 +516,7 @@ void ReadOutcomeList(GameParserState &p_parser, GameRep *p_nfg)
   p_parser.GetNextToken();
 }
 
-void ParseOutcomeBody(GameParserState &p_parser, GameRep *p_nfg)
+void ParseOutcomeBody(GameParserState &p_parser, GameTableRep *p_nfg)
 {
   ReadOutcomeList(p_parser, p_nfg);
 
@@ -590,24 +530,24 @@ void ParseOutcomeBody(GameParserState &p_parser, GameRep *p_nfg)
 
     int outcomeId = atoi(p_parser.GetLastText().c_str());
     if (outcomeId > 0)  {
-      (*iter)->SetOutcome(p_nfg->GetOutcome(outcomeId));
+      p_nfg->SetResult(iter.GetContingency(), p_nfg->GetOutcome(outcomeId));
     }
     else {
-      (*iter)->SetOutcome(0);
+      p_nfg->SetResult(iter.GetContingency(), 0);
     }
     p_parser.GetNextToken();
     iter++;
   }
 }
 
-void ParsePayoffBody(GameParserState &p_parser, GameRep *p_nfg)
+void ParsePayoffBody(GameParserState &p_parser, GameTableRep *p_nfg)
 {
   StrategyIterator iter(StrategySupport(static_cast<GameRep *>(p_nfg)));
   int pl = 1;
 
   while (p_parser.GetCurrentToken() != TOKEN_EOF) {
     if (p_parser.GetCurrentToken() == TOKEN_NUMBER) {
-      (*iter)->GetOutcome()->SetPayoff(pl, p_parser.GetLastText());
+      p_nfg->GetResult(iter.GetContingency())->SetPayoff(pl, p_parser.GetLastText());
     }
     else {
       throw InvalidFileException(p_parser.CreateLineMsg("Expecting payoff"));
@@ -628,7 +568,7 @@ Game BuildNfg(GameParserState &p_parser, TableFileGame &p_data)
     dim[pl] = p_data.NumStrategies(pl);
   }
 
-  GameRep *nfg = NewTable(dim);
+  GameTableRep *nfg = new GameTableRep(dim);
   // Assigning this to the container assures that, if something goes
   // wrong, the class will automatically be cleaned up
   Game game = nfg;
@@ -1026,8 +966,14 @@ Game ReadGame(std::istream &p_file) throw (InvalidFileException)
     else if (parser.GetLastText() == "#BAGG") {
       return GameBagentRep::ReadBaggFile(p_file);
     }
+    else if (parser.GetLastText() == "#NFGBIN") {
+      return GameTableRep::ReadBinaryFile(p_file);
+    }
+    else if (parser.GetLastText() == "#EFGBIN") {
+      return GameTreeRep::ReadBinaryFile(p_file);
+    }
     else {
-      throw InvalidFileException("Tokens 'EFG' or 'NFG' or '#AGG' or '#BAGG' expected at start of file");
+      throw InvalidFileException("Tokens 'EFG' or 'NFG' or '#AGG' or '#BAGG' or '#NFGBIN' or '#EFGBIN' expected at start of file");
     }
   }
   catch (const std::exception &ex) {
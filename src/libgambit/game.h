@@ -231,11 +231,7 @@ public:
   template <class T> const T &GetPayoff(int pl) const 
     { return (const T &) m_payoffs[pl]; }
   /// Sets the payoff to player 'pl'
-  void SetPayoff(int pl, const std::string &p_value)
-  {
-    m_payoffs[pl] = p_value;
-    //m_game->ClearComputedValues();
-  }
+  void SetPayoff(int pl, const std::string &p_value);
   //@}
 };
 
@@ -318,6 +314,7 @@ class GameStrategyRep : public GameObject  {
   friend class PureStrategyProfileRep;
   friend class TreePureStrategyProfileRep;
   friend class TablePureStrategyProfileRep;
+  friend class StrategyContingency;
   template <class T> friend class MixedStrategyProfile;
   template <class T> friend class TableMixedStrategyProfileRep;
   template <class T> friend class MixedBehavProfile;
@@ -518,7 +515,7 @@ public:
   virtual Rational GetStrategyValue(const GameStrategy &) const = 0;
 
   /// Is the profile a pure strategy Nash equilibrium?
-  bool IsNash(void) const;
+  virtual bool IsNash(void) const;
 
   /// Is the profile a strict pure stategy Nash equilibrium?
   bool IsStrictNash(void) const;
@@ -600,6 +597,7 @@ public:
 
 /// This is the class for representing an arbitrary finite game.
 class GameRep : public GameObject {
+  friend class GameOutcomeRep;
   friend class GameTreeInfosetRep;
   friend class GamePlayerRep;
   friend class GameTreeNodeRep;
@@ -624,6 +622,8 @@ protected:
   virtual void BuildComputedValues(void) { }
   /// Have computed values been built?
   virtual bool HasComputedValues(void) const { return false; }
+  /// Discard any tabulation of payoffs, after payoffs have changed
+  virtual void ClearPayoffTable(void) const { }
   //@}
 
 
@@ -669,6 +669,14 @@ public:
   { GameInfoset s, t; return IsPerfectRecall(s, t); }
   //@}
 
+  /// @name Payoff representation
+  //@{
+  /// Enable or disable dense payoff tables, where the representation has them
+  virtual void SetCompactPayoffs(bool) { }
+  /// Returns true if payoffs are read from dense payoff tables
+  virtual bool HasCompactPayoffs(void) const { return false; }
+  //@}
+
   /// @name Writing data files
   //@{
   /// Write the game to a savefile in the specified format.
@@ -761,6 +769,11 @@ Game NewTable(const Array<int> &p_dim, bool p_sparseOutcomes = false);
 // all classes to be defined.
 
 inline Game GameOutcomeRep::GetGame(void) const { return m_game; }
+inline void GameOutcomeRep::SetPayoff(int pl, const std::string &p_value)
+{
+  m_payoffs[pl] = p_value;
+  m_game->ClearPayoffTable();
+}
 
 inline GamePlayer GameStrategyRep::GetPlayer(void) const { return m_player; }
 
@@ -784,7 +797,7 @@ template<> inline std::string PureBehavProfile::GetPayoff(int pl) const
 //=======================================================================
 
 
-/// Reads a game in .efg or .nfg format from the input stream
+/// Reads a game in .efg, .nfg, or binary format from the input stream
 Game ReadGame(std::istream &) throw (InvalidFileException);
 
 } // end namespace gambit
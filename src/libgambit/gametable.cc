@@ -25,6 +25,8 @@
 
 #include "libgambit.h"
 #include "gametable.h"
+#include "binfile.h"
+#include "bufwriter.h"
 
 namespace Gambit {
 
@@ -46,6 +48,7 @@ public:
   virtual void SetOutcome(GameOutcome p_outcome);
   virtual Rational GetPayoff(int pl) const;
   virtual Rational GetStrategyValue(const GameStrategy &) const;
+  virtual bool IsNash(void) const;
 };
 
 //------------------------------------------------------------------------
@@ -90,12 +93,16 @@ GameOutcome TablePureStrategyProfileRep::GetOutcome(void) const
 
 void TablePureStrategyProfileRep::SetOutcome(GameOutcome p_outcome)
 {
-  dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index] = p_outcome; 
+  dynamic_cast<GameTableRep &>(*m_nfg).SetResult(m_index, p_outcome); 
 }
 
 Rational TablePureStrategyProfileRep::GetPayoff(int pl) const
 {
-  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index];
+  GameTableRep &nfg = dynamic_cast<GameTableRep &>(*m_nfg);
+  if (nfg.m_compactPayoffs) {
+    return nfg.GetPayoffTable<Rational>().GetPayoffs(pl)[m_index - 1];
+  }
+  GameOutcomeRep *outcome = nfg.m_results[m_index];
   if (outcome) {
     return outcome->GetPayoff<Rational>(pl);
   }
@@ -108,7 +115,12 @@ Rational
 TablePureStrategyProfileRep::GetStrategyValue(const GameStrategy &p_strategy) const
 {
   int player = p_strategy->GetPlayer()->GetNumber();
-  GameOutcomeRep *outcome = dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index - m_profile[player]->m_offset + p_strategy->m_offset];
+  GameTableRep &nfg = dynamic_cast<GameTableRep &>(*m_nfg);
+  long index = m_index - m_profile[player]->m_offset + p_strategy->m_offset;
+  if (nfg.m_compactPayoffs) {
+    return nfg.GetPayoffTable<Rational>().GetPayoffs(player)[index - 1];
+  }
+  GameOutcomeRep *outcome = nfg.m_results[index];
   if (outcome) {
     return outcome->GetPayoff<Rational>(player);
   }
@@ -117,6 +129,31 @@ TablePureStrategyProfileRep::GetStrategyValue(const GameStrategy &p_strategy) co
   }
 }
 
+bool TablePureStrategyProfileRep::IsNash(void) const
+{
+  const GameTableRep &nfg = dynamic_cast<const GameTableRep &>(*m_nfg);
+  if (!nfg.m_compactPayoffs) {
+    return PureStrategyProfileRep::IsNash();
+  }
+
+  // Deviations are compared in place in the dense table, without
+  // constructing handles or copying payoffs
+  const PayoffTable<Rational> &table = nfg.GetPayoffTable<Rational>();
+  for (int pl = 1; pl <= m_profile.Length(); pl++) {
+    const Rational *payoffs = table.GetPayoffs(pl);
+    const Rational &current = payoffs[m_index - 1];
+    long base = m_index - 1 - m_profile[pl]->m_offset;
+    const GameStrategyArray &strategies = m_profile[pl]->m_player->Strategies();
+    for (GameStrategyArray::const_iterator strategy = strategies.begin();
+	 strategy != strategies.end(); ++strategy) {
+      if (payoffs[base + (*strategy)->m_offset] > current) {
+	return false;
+      }
+    }
+  }
+  return true;
+}
+
 PureStrategyProfile GameTableRep::NewPureStrategyProfile(void) const
 {
   return PureStrategyProfile(new TablePureStrategyProfileRep(const_cast<GameTableRep *>(this)));
@@ -143,6 +180,7 @@ int Product(const Array<int> &dim)
   
 GameTableRep::GameTableRep(const Array<int> &dim, 
 			   bool p_sparseOutcomes /* = false */)
+  : m_compactPayoffs(false), m_payoffVersion(0L)
 {
   m_results = Array<GameOutcomeRep *>(Product(dim));
   for (int pl = 1; pl <= dim.Length(); pl++)  {
@@ -172,7 +210,9 @@ Game GameTableRep::Copy(void) const
   std::ostringstream os;
   WriteNfgFile(os);
   std::istringstream is(os.str());
-  return ReadGame(is);
+  Game game = ReadGame(is);
+  game->SetCompactPayoffs(m_compactPayoffs);
+  return game;
 }
 
 //------------------------------------------------------------------------
@@ -203,6 +243,75 @@ bool GameTableRep::IsConstSum(void) const
   return true;
 }
 
+//------------------------------------------------------------------------
+//                 GameTableRep: Payoff representation
+//------------------------------------------------------------------------
+
+void GameTableRep::SetCompactPayoffs(bool p_compact)
+{
+  m_compactPayoffs = p_compact;
+  if (!m_compactPayoffs) {
+    ClearPayoffTable();
+  }
+}
+
+template<> const PayoffTable<double> &
+GameTableRep::GetPayoffTable<double>(void) const
+{
+  if (m_doublePayoffs.IsEmpty()) {
+    BuildPayoffTable(m_doublePayoffs);
+  }
+  return m_doublePayoffs;
+}
+
+template<> const PayoffTable<Rational> &
+GameTableRep::GetPayoffTable<Rational>(void) const
+{
+  if (m_rationalPayoffs.IsEmpty()) {
+    BuildPayoffTable(m_rationalPayoffs);
+  }
+  return m_rationalPayoffs;
+}
+
+template <class T>
+void GameTableRep::BuildPayoffTable(PayoffTable<T> &p_table) const
+{
+  p_table.Resize(m_players.Length(), m_results.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    T *payoffs = p_table.GetPayoffs(pl);
+    for (long cont = 1; cont <= m_results.Length(); cont++) {
+      if (m_results[cont]) {
+	payoffs[cont - 1] = m_results[cont]->GetPayoff<T>(pl);
+      }
+    }
+  }
+}
+
+void GameTableRep::SetResult(long p_index, GameOutcomeRep *p_outcome)
+{
+  m_results[p_index] = p_outcome;
+  m_payoffVersion++;
+  if (!m_doublePayoffs.IsEmpty()) {
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      m_doublePayoffs.GetPayoffs(pl)[p_index - 1] =
+	(p_outcome) ? p_outcome->GetPayoff<double>(pl) : 0.0;
+    }
+  }
+  if (!m_rationalPayoffs.IsEmpty()) {
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      m_rationalPayoffs.GetPayoffs(pl)[p_index - 1] =
+	(p_outcome) ? p_outcome->GetPayoff<Rational>(pl) : Rational(0);
+    }
+  }
+}
+
+void GameTableRep::ClearPayoffTable(void) const
+{
+  m_payoffVersion++;
+  m_doublePayoffs.Clear();
+  m_rationalPayoffs.Clear();
+}
+
 //------------------------------------------------------------------------
 //                   GameTableRep: Writing data files
 //------------------------------------------------------------------------
@@ -225,57 +334,177 @@ std::string EscapeQuotes(const std::string &s)
 
 void GameTableRep::WriteNfgFile(std::ostream &p_file) const
 { 
-  p_file << "NFG 1 R";
-  p_file << " \"" << EscapeQuotes(GetTitle()) << "\" { ";
+  BufferedWriter writer(p_file);
+  writer << "NFG 1 R";
+  writer << " \"" << EscapeQuotes(GetTitle()) << "\" { ";
 
   for (int i = 1; i <= NumPlayers(); i++)
-    p_file << '"' << EscapeQuotes(GetPlayer(i)->GetLabel()) << "\" ";
+    writer << '"' << EscapeQuotes(GetPlayer(i)->GetLabel()) << "\" ";
 
-  p_file << "}\n\n{ ";
+  writer << "}\n\n{ ";
   
   for (int i = 1; i <= NumPlayers(); i++)   {
     GamePlayerRep *player = GetPlayer(i);
-    p_file << "{ ";
+    writer << "{ ";
     for (int j = 1; j <= player->NumStrategies(); j++)
-      p_file << '"' << EscapeQuotes(player->GetStrategy(j)->GetLabel()) << "\" ";
-    p_file << "}\n";
+      writer << '"' << EscapeQuotes(player->GetStrategy(j)->GetLabel()) << "\" ";
+    writer << "}\n";
   }
   
-  p_file << "}\n";
+  writer << "}\n";
 
-  p_file << "\"" << EscapeQuotes(m_comment) << "\"\n\n";
+  writer << "\"" << EscapeQuotes(m_comment) << "\"\n\n";
 
   int ncont = 1;
   for (int i = 1; i <= NumPlayers(); i++) {
     ncont *= m_players[i]->m_strategies.Length();
   }
 
-  p_file << "{\n";
+  writer << "{\n";
   for (int outc = 1; outc <= m_outcomes.Length(); outc++)   {
-    p_file << "{ \"" << EscapeQuotes(m_outcomes[outc]->m_label) << "\" ";
+    writer << "{ \"" << EscapeQuotes(m_outcomes[outc]->m_label) << "\" ";
     for (int pl = 1; pl <= m_players.Length(); pl++)  {
-      p_file << (const std::string &) m_outcomes[outc]->m_payoffs[pl];
+      writer << (const std::string &) m_outcomes[outc]->m_payoffs[pl];
       
       if (pl < m_players.Length()) {
-	p_file << ", ";
+	writer << ", ";
       }
       else {
-	p_file << " }\n";
+	writer << " }\n";
       }
     }
   }
-  p_file << "}\n";
+  writer << "}\n";
   
   for (int cont = 1; cont <= ncont; cont++)  {
     if (m_results[cont] != 0) {
-      p_file << m_results[cont]->m_number << ' ';
+      writer << m_results[cont]->m_number << ' ';
     }
     else {
-      p_file << "0 ";
+      writer << "0 ";
+    }
+  }
+
+  writer << '\n';
+}
+
+void GameTableRep::WriteBinaryFile(std::ostream &p_file) const
+{
+  BinaryGameWriter writer(p_file, "#NFGBIN");
+  writer.WriteString(m_title);
+  writer.WriteString(m_comment);
+
+  writer.WriteInt(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = m_players[pl];
+    writer.WriteString(player->m_label);
+    writer.WriteInt(player->m_strategies.Length());
+    for (int st = 1; st <= player->m_strategies.Length(); st++) {
+      writer.WriteString(player->m_strategies[st]->m_label);
+    }
+  }
+
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      writer.AddNumber(m_outcomes[outc]->m_payoffs[pl]);
+    }
+  }
+  writer.WriteNumbers();
+
+  writer.WriteInt(m_outcomes.Length());
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    writer.WriteString(m_outcomes[outc]->m_label);
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      writer.WriteNumber(m_outcomes[outc]->m_payoffs[pl]);
+    }
+  }
+
+  // When each contingency has its own outcome, as is the case for
+  // games created from payoff tables, the outcomes are already in
+  // contingency order and the table of results is omitted.
+  bool dense = (m_outcomes.Length() == m_results.Length());
+  for (int cont = 1; dense && cont <= m_results.Length(); cont++) {
+    dense = (m_results[cont] == m_outcomes[cont]);
+  }
+  writer.WriteInt(dense);
+  if (!dense) {
+    for (int cont = 1; cont <= m_results.Length(); cont++) {
+      writer.WriteInt((m_results[cont]) ? m_results[cont]->m_number : 0);
+    }
+  }
+}
+
+Game GameTableRep::ReadBinaryFile(std::istream &p_file)
+{
+  BinaryGameReader reader(p_file);
+  std::string title = reader.ReadString();
+  std::string comment = reader.ReadString();
+
+  // Each player is at least its label and number of strategies, and
+  // each strategy its label
+  Array<int> dim(reader.ReadCount(1, 1 << 16, 8));
+  Array<std::string> labels(dim.Length());
+  Array<Array<std::string> > strategies(dim.Length());
+  long contingencies = 1L;
+  for (int pl = 1; pl <= dim.Length(); pl++) {
+    labels[pl] = reader.ReadString();
+    dim[pl] = reader.ReadCount(1, 1 << 30, 4);
+    if (contingencies > (1L << 30) / dim[pl]) {
+      throw InvalidFileException("Too many contingencies in binary game file");
+    }
+    contingencies *= dim[pl];
+    strategies[pl] = Array<std::string>(dim[pl]);
+    for (int st = 1; st <= dim[pl]; st++) {
+      strategies[pl][st] = reader.ReadString();
+    }
+  }
+
+  // Each contingency has an outcome of its own, or an entry in the table
+  // of results, either of which is at least four bytes
+  reader.Require(4 * contingencies);
+
+  GameTableRep *nfg = new GameTableRep(dim, true);
+  // Assigning this to the container assures that, if something goes
+  // wrong, the class will automatically be cleaned up
+  Game game = nfg;
+  nfg->m_title = title;
+  nfg->m_comment = comment;
+  for (int pl = 1; pl <= dim.Length(); pl++) {
+    nfg->m_players[pl]->m_label = labels[pl];
+    for (int st = 1; st <= dim[pl]; st++) {
+      nfg->m_players[pl]->m_strategies[st]->m_label = strategies[pl][st];
+    }
+  }
+
+  // Each outcome is its label and the index of each payoff
+  reader.ReadNumbers();
+  nfg->m_outcomes = 
+    Array<GameOutcomeRep *>(reader.ReadCount(0, 1 << 30, 4 + 4 * dim.Length()));
+  for (int outc = 1; outc <= nfg->m_outcomes.Length(); outc++) {
+    nfg->m_outcomes[outc] = new GameOutcomeRep(nfg, outc);
+  }
+  for (int outc = 1; outc <= nfg->m_outcomes.Length(); outc++) {
+    GameOutcomeRep *outcome = nfg->m_outcomes[outc];
+    outcome->m_label = reader.ReadString();
+    for (int pl = 1; pl <= dim.Length(); pl++) {
+      outcome->m_payoffs[pl] = reader.ReadNumber();
     }
   }
 
-  p_file << '\n';
+  if (reader.ReadInt(0, 1)) {
+    if (nfg->m_outcomes.Length() != nfg->m_results.Length()) {
+      throw InvalidFileException("Wrong number of outcomes in binary game file");
+    }
+    nfg->m_results = nfg->m_outcomes;
+  }
+  else {
+    for (int cont = 1; cont <= nfg->m_results.Length(); cont++) {
+      int outc = reader.ReadInt(0, nfg->m_outcomes.Length());
+      nfg->m_results[cont] = (outc) ? nfg->m_outcomes[outc] : 0;
+    }
+  }
+
+  return game;
 }
 
 //------------------------------------------------------------------------
@@ -290,6 +519,7 @@ GamePlayer GameTableRep::NewPlayer(void)
   for (int outc = 1; outc <= m_outcomes.Last(); outc++) {
     m_outcomes[outc]->m_payoffs.Append(Number());
   }
+  ClearPayoffTable();
   ClearComputedValues();
   return player;
 }
@@ -309,9 +539,21 @@ void GameTableRep::DeleteOutcome(const GameOutcome &p_outcome)
   for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
     m_outcomes[outc]->m_number = outc;
   }
+  ClearPayoffTable();
   ClearComputedValues();
 }
 
+GameOutcome GameTableRep::GetResult(const StrategyContingency &p_contingency) const
+{
+  return m_results[p_contingency.GetIndex()];
+}
+
+void GameTableRep::SetResult(const StrategyContingency &p_contingency,
+			     const GameOutcome &p_outcome)
+{
+  SetResult(p_contingency.GetIndex(), p_outcome);
+}
+
 //------------------------------------------------------------------------
 //                   GameTableRep: Factory functions
 //------------------------------------------------------------------------
@@ -356,24 +598,26 @@ void GameTableRep::RebuildTable(void)
 
   for (StrategyIterator iter(StrategySupport(const_cast<GameTableRep *>(this)));
        !iter.AtEnd(); iter++) {
+    const StrategyContingency &contingency = iter.GetContingency();
     long newindex = 1L;
     for (int pl = 1; pl <= m_players.Length(); pl++) {
-      if (iter.m_profile->GetStrategy(pl)->m_offset < 0) {
+      if (contingency.GetStrategy(pl)->m_offset < 0) {
 	// This is a contingency involving a new strategy... skip
 	newindex = -1L;
 	break;
       }
       else {
-	newindex += (iter.m_profile->GetStrategy(pl)->m_number - 1) * offsets[pl];
+	newindex += (contingency.GetStrategy(pl)->m_number - 1) * offsets[pl];
       }
     }
 
     if (newindex >= 1) {
-      newResults[newindex] = m_results[iter.m_profile->GetIndex()];
+      newResults[newindex] = m_results[contingency.GetIndex()];
     }
   }
 
   m_results = newResults;
+  ClearPayoffTable();
 
   IndexStrategies();
 }
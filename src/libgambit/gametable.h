@@ -24,20 +24,33 @@
 #define GAMETABLE_H
 
 #include "gameexpl.h"
+#include "payofftable.h"
 
 namespace Gambit {
 
+class StrategyContingency;
+
 class GameTableRep : public GameExplicitRep {
   friend class GamePlayerRep;
   friend class TablePureStrategyProfileRep;
   template <class T> friend class TableMixedStrategyProfileRep;
 private:
   Array<GameOutcomeRep *> m_results;
+  bool m_compactPayoffs;
+  /// Incremented whenever payoffs change, to revalidate computed values
+  mutable long m_payoffVersion;
+  mutable PayoffTable<double> m_doublePayoffs;
+  mutable PayoffTable<Rational> m_rationalPayoffs;
 
   /// @name Private auxiliary functions
   //@{
   void IndexStrategies(void);
   void RebuildTable(void);
+  /// Fills in the payoff table from the outcomes of the contingencies
+  template <class T> void BuildPayoffTable(PayoffTable<T> &) const;
+  /// Sets the outcome of a contingency, keeping payoff tables current
+  void SetResult(long p_index, GameOutcomeRep *p_outcome);
+  virtual void ClearPayoffTable(void) const;
   //@}
 
 public:
@@ -47,6 +60,11 @@ public:
   /// If p_sparseOutcomes = true, outcomes for all contingencies are left null
   GameTableRep(const Array<int> &p_dim, bool p_sparseOutcomes = false);
   virtual Game Copy(void) const;
+  /// \brief Reads a game in the binary format from the stream
+  ///
+  /// Reads a game written by WriteBinaryFile().  The stream is expected
+  /// to be positioned just after the "#NFGBIN" header line.
+  static Game ReadBinaryFile(std::istream &);
   //@}
 
   /// @name General data access
@@ -57,6 +75,20 @@ public:
   { return true; }
   //@}
 
+  /// @name Payoff representation
+  //@{
+  /// Enable or disable dense payoff tables
+  virtual void SetCompactPayoffs(bool);
+  /// Returns true if payoffs are read from dense payoff tables
+  virtual bool HasCompactPayoffs(void) const { return m_compactPayoffs; }
+  /// \brief Returns the dense table of payoffs, building it if needed
+  ///
+  /// The table is built on first use, and is rebuilt after any change
+  /// to the payoffs of the game.  This is only meaningful when the game
+  /// has compact payoffs enabled.
+  template <class T> const PayoffTable<T> &GetPayoffTable(void) const;
+  //@}
+
   /// @name Dimensions of the game
   //@{
   /// The number of actions in each information set
@@ -105,9 +137,18 @@ public:
   virtual void DeleteOutcome(const GameOutcome &);
   //@}
 
+  /// @name Outcomes of contingencies
+  //@{
+  /// Returns the outcome of the contingency
+  GameOutcome GetResult(const StrategyContingency &) const;
+  /// Sets the outcome of the contingency
+  void SetResult(const StrategyContingency &, const GameOutcome &);
+  //@}
+
   /// @name Writing data files
   //@{
   virtual void WriteNfgFile(std::ostream &) const;
+  virtual void WriteBinaryFile(std::ostream &) const;
   //@}
 
   virtual PureStrategyProfile NewPureStrategyProfile(void) const;
@@ -118,6 +159,11 @@ public:
 
 };
 
+template<> const PayoffTable<double> &
+GameTableRep::GetPayoffTable<double>(void) const;
+template<> const PayoffTable<Rational> &
+GameTableRep::GetPayoffTable<Rational>(void) const;
+
 }
 
 
@@ -25,6 +25,8 @@
 
 #include "libgambit.h"
 #include "gametree.h"
+#include "binfile.h"
+#include "bufwriter.h"
 
 namespace Gambit {
 
@@ -550,12 +552,16 @@ GameInfoset GameTreeNodeRep::InsertMove(GameInfoset p_infoset)
 GameTreeRep::GameTreeRep(void)
 {
   m_computedValues = false;
+  m_flatTree = 0;
+  m_compactPayoffs = false;
+  m_numContingencies = 0;
   m_chance = new GamePlayerRep(this, 0);
   m_root = new GameTreeNodeRep(this, 0);
 }
 
 GameTreeRep::~GameTreeRep()
 {
+  delete m_flatTree;
   m_root->Invalidate();
   m_chance->Invalidate();
 }
@@ -565,7 +571,9 @@ Game GameTreeRep::Copy(void) const
   std::ostringstream os;
   WriteEfgFile(os);
   std::istringstream is(os.str());
-  return ReadGame(is);
+  Game game = ReadGame(is);
+  game->SetCompactPayoffs(m_compactPayoffs);
+  return game;
 }
 
 Game NewTree(void)  { return new GameTreeRep(); }
@@ -574,6 +582,14 @@ Game NewTree(void)  { return new GameTreeRep(); }
 //                 GameTreeRep: General data access
 //------------------------------------------------------------------------
 
+void GameTreeRep::SetCompactPayoffs(bool p_compact)
+{
+  m_compactPayoffs = p_compact;
+  if (!m_compactPayoffs) {
+    ClearPayoffTable();
+  }
+}
+
 namespace {
 
 class NotZeroSumException : public Exception {
@@ -738,9 +754,18 @@ void GameTreeRep::ClearComputedValues(void) const
     }
   }
 
+  delete m_flatTree;
+  m_flatTree = 0;
+  ClearPayoffTable();
   m_computedValues = false;
 }
 
+void GameTreeRep::ClearPayoffTable(void) const
+{
+  m_reducedPayoffs.Clear();
+  m_tabulated.clear();
+}
+
 void GameTreeRep::BuildComputedValues(void)
 {
   if (m_computedValues) return;
@@ -756,6 +781,33 @@ void GameTreeRep::BuildComputedValues(void)
 	 m_players[pl]->m_strategies[st++]->m_id = id++);
   }
 
+  // Offsets index the contingencies of the reduced strategic form;
+  // they are only assigned if the table would be small enough to build
+  long contingencies = 1L;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    int numStrats = m_players[pl]->m_strategies.Length();
+    if (contingencies > c_maxTabulatedPayoffs / numStrats) {
+      contingencies = 0L;
+      break;
+    }
+    contingencies *= numStrats;
+  }
+  if (contingencies * m_players.Length() > c_maxTabulatedPayoffs) {
+    contingencies = 0L;
+  }
+  m_numContingencies = contingencies;
+  long offset = 1L;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = m_players[pl];
+    for (int st = 1; st <= player->m_strategies.Length(); st++) {
+      player->m_strategies[st]->m_offset = 
+	(m_numContingencies > 0) ? (st - 1) * offset : 0L;
+    }
+    if (m_numContingencies > 0) {
+      offset *= player->m_strategies.Length();
+    }
+  }
+
   m_computedValues = true;
 }
 
@@ -881,39 +933,227 @@ void GameTreeRep::WriteNfgFile(std::ostream &p_file) const
   // FIXME: Building computed values is logically const.
   const_cast<GameTreeRep *>(this)->BuildComputedValues();
 
-  p_file << "NFG 1 R";
-  p_file << " \"" << EscapeQuotes(GetTitle()) << "\" { ";
+  BufferedWriter writer(p_file);
+  writer << "NFG 1 R";
+  writer << " \"" << EscapeQuotes(GetTitle()) << "\" { ";
 
   for (int i = 1; i <= NumPlayers(); i++)
-    p_file << '"' << EscapeQuotes(GetPlayer(i)->GetLabel()) << "\" ";
+    writer << '"' << EscapeQuotes(GetPlayer(i)->GetLabel()) << "\" ";
 
-  p_file << "}\n\n{ ";
+  writer << "}\n\n{ ";
   
   for (int i = 1; i <= NumPlayers(); i++)   {
     GamePlayerRep *player = GetPlayer(i);
-    p_file << "{ ";
+    writer << "{ ";
     for (int j = 1; j <= player->NumStrategies(); j++)
-      p_file << '"' << EscapeQuotes(player->GetStrategy(j)->GetLabel()) << "\" ";
-    p_file << "}\n";
+      writer << '"' << EscapeQuotes(player->GetStrategy(j)->GetLabel()) << "\" ";
+    writer << "}\n";
   }
   
-  p_file << "}\n";
+  writer << "}\n";
 
-  p_file << "\"" << EscapeQuotes(m_comment) << "\"\n\n";
+  writer << "\"" << EscapeQuotes(m_comment) << "\"\n\n";
 
   // For trees, we write the payoff version, since there need not be
   // a one-to-one correspondence between outcomes and entries, when there
-  // are chance moves.
-  StrategyIterator iter(Game(const_cast<GameTreeRep *>(this)));
-    
-  for (; !iter.AtEnd(); iter++) {
-    for (int pl = 1; pl <= NumPlayers(); pl++) {
-      p_file << (*iter)->GetPayoff(pl) << " ";
+  // are chance moves.  The payoffs of each contingency are computed in
+  // turn as they are written, so the reduced strategic form is never
+  // held in memory.
+  Array<GameStrategy> profile(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    profile[pl] = m_players[pl]->m_strategies[1];
+  }
+  Array<int> current(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); current[pl++] = 1);
+  Array<Rational> payoffs(m_players.Length());
+
+  while (true) {
+    ComputePurePayoffs(profile, 0, payoffs);
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      writer << payoffs[pl] << ' ';
+    }
+    writer << '\n';
+
+    // Advance to the next contingency, with player 1 varying fastest
+    int pl = 1;
+    for (; pl <= m_players.Length(); pl++) {
+      GamePlayerRep *player = m_players[pl];
+      if (current[pl] < player->m_strategies.Length()) {
+	profile[pl] = player->m_strategies[++current[pl]];
+	break;
+      }
+      current[pl] = 1;
+      profile[pl] = player->m_strategies[1];
+    }
+    if (pl > m_players.Length()) {
+      break;
+    }
+  }
+
+  writer << '\n';
+}
+
+void GameTreeRep::WriteBinaryFile(std::ostream &p_file) const
+{
+  BinaryGameWriter writer(p_file, "#EFGBIN");
+  writer.WriteString(m_title);
+  writer.WriteString(m_comment);
+
+  writer.WriteInt(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    writer.WriteString(m_players[pl]->m_label);
+  }
+
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      writer.AddNumber(m_outcomes[outc]->m_payoffs[pl]);
+    }
+  }
+  for (int iset = 1; iset <= m_chance->m_infosets.Length(); iset++) {
+    GameTreeInfosetRep *infoset = m_chance->m_infosets[iset];
+    for (int act = 1; act <= infoset->m_probs.Length(); act++) {
+      writer.AddNumber(infoset->m_probs[act]);
+    }
+  }
+  writer.WriteNumbers();
+
+  writer.WriteInt(m_outcomes.Length());
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    writer.WriteString(m_outcomes[outc]->m_label);
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      writer.WriteNumber(m_outcomes[outc]->m_payoffs[pl]);
+    }
+  }
+
+  // Information sets are listed for each player, starting with chance
+  for (int pl = 0; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
+    writer.WriteInt(player->m_infosets.Length());
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      GameTreeInfosetRep *infoset = player->m_infosets[iset];
+      writer.WriteString(infoset->m_label);
+      writer.WriteInt(infoset->m_actions.Length());
+      for (int act = 1; act <= infoset->m_actions.Length(); act++) {
+	writer.WriteString(infoset->m_actions[act]->m_label);
+	if (pl == 0) {
+	  writer.WriteNumber(infoset->m_probs[act]);
+	}
+      }
+    }
+  }
+
+  // Nodes are listed in preorder.  The player is written as zero for
+  // terminal nodes, and one more than the player number otherwise, so
+  // chance is written as one; the number of children of a node is the
+  // number of actions at its information set.
+  writer.WriteInt(NumNodes());
+  std::vector<GameTreeNodeRep *> stack(1, m_root);
+  while (!stack.empty()) {
+    GameTreeNodeRep *node = stack.back();
+    stack.pop_back();
+    writer.WriteString(node->m_label);
+    writer.WriteInt((node->outcome) ? node->outcome->m_number : 0);
+    if (node->children.Length() == 0) {
+      writer.WriteInt(0);
+      continue;
+    }
+    writer.WriteInt(node->infoset->m_player->m_number + 1);
+    writer.WriteInt(node->infoset->m_number);
+    for (int i = node->children.Length(); i >= 1; i--) {
+      stack.push_back(node->children[i]);
+    }
+  }
+}
+
+Game GameTreeRep::ReadBinaryFile(std::istream &p_file)
+{
+  BinaryGameReader reader(p_file);
+  GameTreeRep *efg = new GameTreeRep;
+  // Assigning this to the container assures that, if something goes
+  // wrong, the class will automatically be cleaned up
+  Game game = efg;
+  efg->m_title = reader.ReadString();
+  efg->m_comment = reader.ReadString();
+
+  // Counts are checked against the fewest bytes each record can take:
+  // a label for a player, a label and the index of each payoff for an
+  // outcome, and a label and number of actions for an information set,
+  // with a label and, at chance, the index of a probability for each
+  // action
+  int numPlayers = reader.ReadCount(0, 1 << 16, 4);
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    efg->m_players.Append(new GamePlayerRep(efg, pl));
+    efg->m_players[pl]->m_label = reader.ReadString();
+  }
+
+  reader.ReadNumbers();
+  efg->m_outcomes = 
+    Array<GameOutcomeRep *>(reader.ReadCount(0, 1 << 30, 4 + 4 * numPlayers));
+  for (int outc = 1; outc <= efg->m_outcomes.Length(); outc++) {
+    efg->m_outcomes[outc] = new GameOutcomeRep(efg, outc);
+  }
+  for (int outc = 1; outc <= efg->m_outcomes.Length(); outc++) {
+    GameOutcomeRep *outcome = efg->m_outcomes[outc];
+    outcome->m_label = reader.ReadString();
+    for (int pl = 1; pl <= numPlayers; pl++) {
+      outcome->m_payoffs[pl] = reader.ReadNumber();
+    }
+  }
+
+  for (int pl = 0; pl <= numPlayers; pl++) {
+    GamePlayerRep *player = (pl) ? efg->m_players[pl] : efg->m_chance;
+    int numInfosets = reader.ReadCount(0, 1 << 30, 8);
+    for (int iset = 1; iset <= numInfosets; iset++) {
+      std::string label = reader.ReadString();
+      int numActions = reader.ReadCount(1, 1 << 30, (pl == 0) ? 8 : 4);
+      GameTreeInfosetRep *infoset = 
+	new GameTreeInfosetRep(efg, iset, player, numActions);
+      infoset->m_label = label;
+      for (int act = 1; act <= infoset->m_actions.Length(); act++) {
+	infoset->m_actions[act]->m_label = reader.ReadString();
+	if (pl == 0) {
+	  infoset->m_probs[act] = reader.ReadNumber();
+	}
+      }
     }
-    p_file << "\n";
   }
 
-  p_file << '\n';
+  // Each node is at least its label, outcome and player
+  int numNodes = reader.ReadCount(1, 1 << 30, 12);
+  std::vector<GameTreeNodeRep *> stack(1, efg->m_root);
+  for (; numNodes > 0 && !stack.empty(); numNodes--) {
+    GameTreeNodeRep *node = stack.back();
+    stack.pop_back();
+    node->m_label = reader.ReadString();
+    int outc = reader.ReadInt(0, efg->m_outcomes.Length());
+    node->outcome = (outc) ? efg->m_outcomes[outc] : 0;
+    int pl = reader.ReadInt(0, numPlayers + 1);
+    if (pl == 0) {
+      continue;
+    }
+    GamePlayerRep *player = (pl > 1) ? efg->m_players[pl - 1] : efg->m_chance;
+    node->infoset = 
+      player->m_infosets[reader.ReadInt(1, player->m_infosets.Length())];
+    // The children, and the nodes already waiting, are still to be read
+    if (static_cast<size_t>(node->infoset->m_actions.Length()) + stack.size() >
+	static_cast<size_t>(numNodes - 1)) {
+      throw InvalidFileException("Wrong number of nodes in binary game file");
+    }
+    node->infoset->AddMember(node);
+    node->children = Array<GameTreeNodeRep *>(node->infoset->m_actions.Length());
+    for (int i = 1; i <= node->children.Length(); i++) {
+      node->children[i] = new GameTreeNodeRep(efg, node);
+    }
+    for (int i = node->children.Length(); i >= 1; i--) {
+      stack.push_back(node->children[i]);
+    }
+  }
+  if (numNodes > 0 || !stack.empty()) {
+    throw InvalidFileException("Wrong number of nodes in binary game file");
+  }
+
+  efg->Canonicalize();
+  return game;
 }
 
 //------------------------------------------------------------------------
@@ -1059,6 +1299,105 @@ int GameTreeRep::NumNodes(void) const
   return CountNodes(m_root);
 }
 
+const GameTreeFlatView &GameTreeRep::GetFlatTree(void) const
+{
+  if (m_flatTree) return *m_flatTree;
+
+  GameTreeFlatView *view = new GameTreeFlatView;
+  view->m_numPlayers = m_players.Length();
+
+  // Information sets and actions.  Chance is numbered after the
+  // personal players, so global indices agree with GetInfoset() and
+  // GetAction().
+  view->m_infosets.push_back(0);
+  view->m_infosetPlayer.push_back(0);
+  view->m_infosetNumber.push_back(0);
+  view->m_infosetOffset.resize(m_players.Length() + 1);
+  view->m_actionStart.push_back(0);
+  view->m_memberStart.push_back(0);
+  view->m_members.push_back(0);
+  view->m_actionInfoset.push_back(0);
+  view->m_chanceProbs.push_back(0.0);
+  view->m_chanceProbsRational.push_back(Rational(0));
+  for (int i = 1; i <= m_players.Length() + 1; i++) {
+    int pl = (i <= m_players.Length()) ? i : 0;
+    GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
+    view->m_infosetOffset[pl] = view->m_infosets.size() - 1;
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      GameTreeInfosetRep *infoset = player->m_infosets[iset];
+      int index = view->m_infosets.size();
+      view->m_infosets.push_back(infoset);
+      view->m_infosetPlayer.push_back(pl);
+      view->m_infosetNumber.push_back(iset);
+      view->m_actionStart.push_back(view->m_actionInfoset.size());
+      view->m_memberStart.push_back(view->m_members.size());
+      for (int j = 1; j <= infoset->m_members.Length(); j++) {
+	view->m_members.push_back(infoset->m_members[j]->number);
+      }
+      for (int act = 1; act <= infoset->m_actions.Length(); act++) {
+	view->m_actionInfoset.push_back(index);
+	if (pl == 0) {
+	  view->m_chanceProbs.push_back(infoset->GetActionProb(act, 0.0));
+	  view->m_chanceProbsRational.push_back(infoset->GetActionProb(act, Rational(0)));
+	}
+	else {
+	  view->m_chanceProbs.push_back(0.0);
+	  view->m_chanceProbsRational.push_back(Rational(0));
+	}
+      }
+    }
+  }
+  view->m_actionStart.push_back(view->m_actionInfoset.size());
+  view->m_memberStart.push_back(view->m_members.size());
+
+  // Nodes, visited in preorder using an explicit stack, so that the
+  // index of each node is its number
+  int numNodes = NumNodes();
+  view->m_nodes.resize(numNodes + 1, 0);
+  view->m_parent.resize(numNodes + 1, 0);
+  view->m_priorAction.resize(numNodes + 1, 0);
+  view->m_infoset.resize(numNodes + 1, 0);
+  view->m_outcome.resize(numNodes + 1, 0);
+  view->m_subtreeEnd.resize(numNodes + 1, 0);
+  view->m_childStart.resize(numNodes + 2, 0);
+  view->m_children.push_back(0);
+
+  std::vector<GameTreeNodeRep *> stack;
+  stack.push_back(m_root);
+  while (!stack.empty()) {
+    GameTreeNodeRep *node = stack.back();
+    stack.pop_back();
+    int n = node->number;
+    view->m_nodes[n] = node;
+    view->m_outcome[n] = (node->outcome) ? node->outcome->m_number : 0;
+    view->m_childStart[n] = view->m_children.size();
+    if (node->children.Length() > 0) {
+      GameTreeInfosetRep *infoset = node->infoset;
+      int index = view->GetInfosetIndex(infoset->m_player->m_number,
+					infoset->m_number);
+      view->m_infoset[n] = index;
+      for (int i = 1; i <= node->children.Length(); i++) {
+	int child = node->children[i]->number;
+	view->m_children.push_back(child);
+	view->m_parent[child] = n;
+	view->m_priorAction[child] = view->m_actionStart[index] + i - 1;
+      }
+      for (int i = node->children.Length(); i >= 1; i--) {
+	stack.push_back(node->children[i]);
+      }
+    }
+  }
+  view->m_childStart[numNodes + 1] = view->m_children.size();
+
+  for (int n = numNodes; n >= 1; n--) {
+    view->m_subtreeEnd[n] = ((view->NumChildren(n) > 0) ? 
+			     view->m_subtreeEnd[view->m_children[view->m_childStart[n+1] - 1]] : n);
+  }
+
+  m_flatTree = view;
+  return *m_flatTree;
+}
+
 //------------------------------------------------------------------------
 //                     GameTreeRep: Factory functions
 //------------------------------------------------------------------------
@@ -1090,6 +1429,9 @@ MixedStrategyProfile<Rational> GameTreeRep::NewMixedStrategyProfile(const Ration
 
 class TreePureStrategyProfileRep : public PureStrategyProfileRep {
 protected:
+  /// The index of the contingency in the reduced strategic form
+  long m_index;
+
   virtual PureStrategyProfileRep *Copy(void) const;
 
 public:
@@ -1109,10 +1451,12 @@ public:
 
 TreePureStrategyProfileRep::TreePureStrategyProfileRep(const Game &p_nfg)
 {
+  m_index = 1L;
   m_nfg = p_nfg;
   m_profile = Array<GameStrategy>(m_nfg->NumPlayers());
   for (int pl = 1; pl <= m_nfg->NumPlayers(); pl++)   {
     m_profile[pl] = m_nfg->GetPlayer(pl)->GetStrategy(1);
+    m_index += m_profile[pl]->m_offset;
   }
 }
 
@@ -1132,30 +1476,100 @@ PureStrategyProfile GameTreeRep::NewPureStrategyProfile(void) const
 
 void TreePureStrategyProfileRep::SetStrategy(const GameStrategy &s)
 {
+  m_index += s->m_offset - m_profile[s->GetPlayer()->GetNumber()]->m_offset;
   m_profile[s->GetPlayer()->GetNumber()] = s;
 }
 
 Rational TreePureStrategyProfileRep::GetPayoff(int pl) const
 {
-  PureBehavProfile behav(m_nfg);
-  for (int i = 1; i <= m_nfg->NumPlayers(); i++) {
-    GamePlayer player = m_nfg->GetPlayer(i);
-    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-      int act = m_profile[i]->m_behav[iset];
-      if (act) {
-	behav.SetAction(player->GetInfoset(iset)->GetAction(act));
+  const GameTreeRep &efg = dynamic_cast<const GameTreeRep &>(*m_nfg);
+  return efg.GetPurePayoff(m_profile, 0, m_index, pl);
+}
+
+Rational
+TreePureStrategyProfileRep::GetStrategyValue(const GameStrategy &p_strategy) const
+{
+  const GameTreeRep &efg = dynamic_cast<const GameTreeRep &>(*m_nfg);
+  int player = p_strategy->GetPlayer()->GetNumber();
+  long index = m_index - m_profile[player]->m_offset + p_strategy->m_offset;
+  return efg.GetPurePayoff(m_profile, p_strategy, index, player);
+}
+
+//------------------------------------------------------------------------
+//            GameTreeRep: Payoffs of pure strategy profiles
+//------------------------------------------------------------------------
+
+void GameTreeRep::ComputePurePayoffs(const Array<GameStrategy> &p_profile,
+				     const GameStrategyRep *p_strategy,
+				     Array<Rational> &p_payoffs) const
+{
+  const GameTreeFlatView &tree = GetFlatTree();
+  for (int pl = 1; pl <= p_payoffs.Length(); pl++) {
+    p_payoffs[pl] = Rational(0);
+  }
+
+  // Each entry is the start of a path, and the probability with which
+  // chance reaches it; the path is extended until a terminal node
+  std::vector<std::pair<int, Rational> > paths;
+  paths.push_back(std::pair<int, Rational>(1, Rational(1)));
+  while (!paths.empty()) {
+    int node = paths.back().first;
+    Rational prob = paths.back().second;
+    paths.pop_back();
+    while (node) {
+      if (tree.GetOutcome(node)) {
+	GameOutcomeRep *outcome = tree.GetNode(node)->outcome;
+	for (int pl = 1; pl <= p_payoffs.Length(); pl++) {
+	  p_payoffs[pl] += prob * outcome->GetPayoff<Rational>(pl);
+	}
+      }
+      int infoset = tree.GetInfoset(node);
+      if (!infoset) break;
+      int player = tree.GetInfosetPlayer(infoset);
+      if (player == 0) {
+	int first = tree.GetFirstAction(infoset);
+	for (int act = tree.NumChildren(node); act > 1; act--) {
+	  paths.push_back(std::pair<int, Rational>(tree.GetChild(node, act),
+						   prob * tree.GetChanceProb(first + act - 1,
+									     Rational(0))));
+	}
+	prob *= tree.GetChanceProb(first, Rational(0));
+	node = tree.GetChild(node, 1);
+      }
+      else {
+	const GameStrategyRep *strategy = 
+	  ((p_strategy && p_strategy->m_player->m_number == player) ?
+	   p_strategy : p_profile[player].operator->());
+	int act = strategy->m_behav[tree.GetInfosetNumber(infoset)];
+	node = tree.GetChild(node, (act) ? act : 1);
       }
     }
   }
-  return behav.GetPayoff<Rational>(pl);
 }
 
-Rational
-TreePureStrategyProfileRep::GetStrategyValue(const GameStrategy &p_strategy) const
+Rational GameTreeRep::GetPurePayoff(const Array<GameStrategy> &p_profile,
+				    const GameStrategyRep *p_strategy,
+				    long p_index, int pl) const
 {
-  PureStrategyProfile copy = Copy();
-  copy->SetStrategy(p_strategy);
-  return copy->GetPayoff(p_strategy->GetPlayer()->GetNumber());
+  if (!m_compactPayoffs || m_numContingencies == 0) {
+    Array<Rational> payoffs(m_players.Length());
+    ComputePurePayoffs(p_profile, p_strategy, payoffs);
+    return payoffs[pl];
+  }
+
+  if (m_reducedPayoffs.IsEmpty()) {
+    m_reducedPayoffs.Resize(m_players.Length(), m_numContingencies);
+    m_tabulated.assign(m_numContingencies, false);
+  }
+  if (!m_tabulated[p_index - 1]) {
+    Array<Rational> payoffs(m_players.Length());
+    ComputePurePayoffs(p_profile, p_strategy, payoffs);
+    for (int i = 1; i <= m_players.Length(); i++) {
+      m_reducedPayoffs.GetPayoffs(i)[p_index - 1] = payoffs[i];
+    }
+    m_tabulated[p_index - 1] = true;
+  }
+  return m_reducedPayoffs.GetPayoffs(pl)[p_index - 1];
 }
 
 
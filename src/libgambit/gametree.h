@@ -23,7 +23,9 @@
 #ifndef GAMETREE_H
 #define GAMETREE_H
 
+#include <vector>
 #include "gameexpl.h"
+#include "payofftable.h"
 
 namespace Gambit {
 
@@ -196,18 +198,169 @@ public:
 };
 
 
+/// \brief A read-only, flattened view of the structure of a game tree
+///
+/// The view lays out the tree in contiguous integer arrays, so that
+/// evaluators and solvers can traverse it with plain loops instead of
+/// recursing through the node objects.  Nodes are indexed by their
+/// numbers in the game, which run in depth-first preorder: each node
+/// comes after its parent, and the descendants of node n are exactly
+/// the nodes n+1 through GetSubtreeEnd(n).  Information sets are indexed
+/// globally, those of the personal players in order followed by those of
+/// chance, and actions are indexed globally in the same order.  All
+/// indices are 1-based, with zero meaning "none".
+///
+/// A view is obtained from GameTreeRep::GetFlatTree(), and remains valid
+/// until the next change to the game, other than to outcome payoffs.
+class GameTreeFlatView {
+  friend class GameTreeRep;
+private:
+  int m_numPlayers;
+
+  /// @name Nodes
+  //@{
+  std::vector<GameTreeNodeRep *> m_nodes;
+  std::vector<int> m_parent, m_priorAction, m_infoset, m_outcome;
+  std::vector<int> m_subtreeEnd;
+  /// Children of node n are m_children[m_childStart[n]..m_childStart[n+1]-1]
+  std::vector<int> m_childStart, m_children;
+  //@}
+
+  /// @name Information sets
+  //@{
+  std::vector<GameTreeInfosetRep *> m_infosets;
+  std::vector<int> m_infosetPlayer, m_infosetNumber;
+  /// Global index, less one, of the first information set of each player
+  std::vector<int> m_infosetOffset;
+  /// Actions at infoset i are m_actionStart[i]..m_actionStart[i+1]-1
+  std::vector<int> m_actionStart;
+  /// Members of infoset i are m_members[m_memberStart[i]..m_memberStart[i+1]-1]
+  std::vector<int> m_memberStart, m_members;
+  //@}
+
+  /// @name Actions
+  //@{
+  std::vector<int> m_actionInfoset;
+  std::vector<double> m_chanceProbs;
+  std::vector<Rational> m_chanceProbsRational;
+  //@}
+
+  GameTreeFlatView(void) : m_numPlayers(0) { }
+
+  /// @name Disallowed copying
+  //@{
+  GameTreeFlatView(const GameTreeFlatView &);
+  GameTreeFlatView &operator=(const GameTreeFlatView &);
+  //@}
+
+public:
+  /// @name Dimensions
+  //@{
+  int NumPlayers(void) const { return m_numPlayers; }
+  int NumNodes(void) const { return m_nodes.size() - 1; }
+  /// Returns the number of information sets, including those of chance
+  int NumInfosets(void) const { return m_infosets.size() - 1; }
+  /// Returns the number of actions, including those of chance
+  int NumActions(void) const { return m_actionInfoset.size() - 1; }
+  //@}
+
+  /// @name Nodes
+  //@{
+  GameTreeNodeRep *GetNode(int n) const { return m_nodes[n]; }
+  /// Returns the parent of the node, or zero for the root
+  int GetParent(int n) const { return m_parent[n]; }
+  /// Returns the action leading to the node, or zero for the root
+  int GetPriorAction(int n) const { return m_priorAction[n]; }
+  /// Returns the information set at the node, or zero if terminal
+  int GetInfoset(int n) const { return m_infoset[n]; }
+  /// Returns the number of the outcome at the node, or zero if none
+  int GetOutcome(int n) const { return m_outcome[n]; }
+  /// Returns the last node in the subtree rooted at the node
+  int GetSubtreeEnd(int n) const { return m_subtreeEnd[n]; }
+  int NumChildren(int n) const { return m_childStart[n+1] - m_childStart[n]; }
+  /// Returns the first child of the node, or zero if terminal
+  int GetFirstChild(int n) const 
+  { return (NumChildren(n) > 0) ? m_children[m_childStart[n]] : 0; }
+  /// Returns the ith child of the node
+  int GetChild(int n, int i) const { return m_children[m_childStart[n]+i-1]; }
+  //@}
+
+  /// @name Information sets
+  //@{
+  GameTreeInfosetRep *GetInfosetRep(int i) const { return m_infosets[i]; }
+  /// Returns the number of the player at the infoset, or zero for chance
+  int GetInfosetPlayer(int i) const { return m_infosetPlayer[i]; }
+  /// Returns the number of the infoset among those of its player
+  int GetInfosetNumber(int i) const { return m_infosetNumber[i]; }
+  /// Returns the global index of player pl's iset'th information set
+  int GetInfosetIndex(int pl, int iset) const 
+  { return m_infosetOffset[pl] + iset; }
+  int NumMembers(int i) const { return m_memberStart[i+1] - m_memberStart[i]; }
+  /// Returns the jth member of the information set
+  int GetMember(int i, int j) const { return m_members[m_memberStart[i]+j-1]; }
+  int NumActions(int i) const { return m_actionStart[i+1] - m_actionStart[i]; }
+  /// Returns the global index of the first action at the information set
+  int GetFirstAction(int i) const { return m_actionStart[i]; }
+  //@}
+
+  /// @name Actions
+  //@{
+  /// Returns the information set at which the action is taken
+  int GetActionInfoset(int a) const { return m_actionInfoset[a]; }
+  /// Returns the number of the action within its information set
+  int GetActionNumber(int a) const 
+  { return a - m_actionStart[m_actionInfoset[a]] + 1; }
+  /// Returns the probability of a chance action, or zero otherwise
+  double GetChanceProb(int a, double) const { return m_chanceProbs[a]; }
+  /// Returns the probability of a chance action, or zero otherwise
+  const Rational &GetChanceProb(int a, const Rational &) const
+  { return m_chanceProbsRational[a]; }
+  //@}
+};
+
 class GameTreeRep : public GameExplicitRep {
   friend class GameTreeNodeRep;
   friend class GameTreeInfosetRep;
   friend class GameTreeActionRep;
+  friend class TreePureStrategyProfileRep;
 protected:
   mutable bool m_computedValues;
   GameTreeNodeRep *m_root;
   GamePlayerRep *m_chance;
+  mutable GameTreeFlatView *m_flatTree;
+
+  /// @name Tabulation of the reduced strategic form
+  //@{
+  /// The largest table, in payoff entries, that will be built
+  static const long c_maxTabulatedPayoffs = 1L << 20;
+  bool m_compactPayoffs;
+  /// The number of contingencies, or zero if too many to tabulate
+  long m_numContingencies;
+  /// Payoffs of the contingencies computed so far, indexed by offset sum
+  mutable PayoffTable<Rational> m_reducedPayoffs;
+  mutable std::vector<bool> m_tabulated;
+  //@}
 
   /// @name Private auxiliary functions
   //@{
   void NumberNodes(GameTreeNodeRep *, int &);
+  /// \brief Computes the payoffs to the players from a pure strategy profile
+  ///
+  /// Only the actions selected by the profile are followed, branching
+  /// only at chance nodes.  If p_strategy is not null, it is played in
+  /// place of the profile's strategy for its player.
+  void ComputePurePayoffs(const Array<GameStrategy> &p_profile,
+			  const GameStrategyRep *p_strategy,
+			  Array<Rational> &p_payoffs) const;
+  /// \brief Returns the payoff to player pl in a contingency
+  ///
+  /// The contingency is that of p_profile, with p_strategy substituted
+  /// if not null, and has table index p_index.  The payoffs are looked
+  /// up in, or added to, the table of the reduced strategic form when
+  /// tabulation is enabled and the table is within the size limit.
+  Rational GetPurePayoff(const Array<GameStrategy> &p_profile,
+			 const GameStrategyRep *p_strategy,
+			 long p_index, int pl) const;
   //@}
 
   /// @name Managing the representation
@@ -217,6 +370,7 @@ protected:
   virtual void ClearComputedValues(void) const;
   /// Have computed values been built?
   virtual bool HasComputedValues(void) const { return m_computedValues; }
+  virtual void ClearPayoffTable(void) const;
   //@}
 
 public: 
@@ -225,6 +379,11 @@ public:
   GameTreeRep(void);
   virtual ~GameTreeRep();
   virtual Game Copy(void) const;
+  /// \brief Reads a game in the binary format from the stream
+  ///
+  /// Reads a game written by WriteBinaryFile().  The stream is expected
+  /// to be positioned just after the "#EFGBIN" header line.
+  static Game ReadBinaryFile(std::istream &);
   //@}
 
   /// @name General data access
@@ -234,6 +393,18 @@ public:
   virtual bool IsPerfectRecall(GameInfoset &, GameInfoset &) const;
   //@}
 
+  /// @name Payoff representation
+  //@{
+  /// \brief Enable or disable tabulation of the reduced strategic form
+  ///
+  /// When enabled, the payoffs of each contingency of the reduced
+  /// strategic form are stored the first time they are computed, provided
+  /// the whole table would have at most c_maxTabulatedPayoffs entries.
+  virtual void SetCompactPayoffs(bool);
+  /// Returns true if payoffs of the reduced strategic form are tabulated
+  virtual bool HasCompactPayoffs(void) const { return m_compactPayoffs; }
+  //@}
+
   /// @name Players
   //@{
   /// Returns the chance (nature) player
@@ -248,6 +419,8 @@ public:
   virtual GameNode GetRoot(void) const { return m_root; } 
   /// Returns the number of nodes in the game
   int NumNodes(void) const;
+  /// Returns a flattened view of the tree, building it if needed
+  const GameTreeFlatView &GetFlatTree(void) const;
   //@}
 
   virtual void DeleteOutcome(const GameOutcome &);
@@ -257,6 +430,7 @@ public:
   virtual void WriteEfgFile(std::ostream &) const;
   virtual void WriteEfgFile(std::ostream &, const GameNode &p_node) const;
   virtual void WriteNfgFile(std::ostream &) const;
+  virtual void WriteBinaryFile(std::ostream &) const;
   //@}
 
   /// @name Dimensions of the game
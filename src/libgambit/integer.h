@@ -5,7 +5,8 @@
 // FILE: src/libgambit/integer.h
 // Interface to an arbitrary-length integer class
 //
-// The original copyright and license are included below.
+// The interface follows the Integer class of the GNU C++ Library, whose
+// original copyright and license are included below.
 //
 
 /* 
@@ -28,87 +29,101 @@ Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
 #ifndef LIBGAMBIT_INTEGER_H
 #define LIBGAMBIT_INTEGER_H
 
+#include <climits>
 #include <string>
+#include <iosfwd>
 
 namespace Gambit {
 
-struct IntegerRep                    // internal Integer representations
-{
-  unsigned short  len;          // current length
-  unsigned short  sz;           // allocated space (0 means static).
-  short           sgn;          // 1 means >= 0; 0 means < 0 
-  unsigned short  s[1];         // represented as ushort array starting here
-};
+struct IntegerRep;
+
+/// \brief An arbitrary-length integer
+///
+/// Values which fit in a long are held inline in the object, and
+/// arithmetic on them is carried out in machine words, checking for
+/// overflow.  Only when a result overflows is it moved to a separately
+/// allocated magnitude, stored in machine-word limbs.  The representation
+/// is canonical: a value is held inline if and only if it lies in the
+/// inline range [-LONG_MAX, LONG_MAX].  (LONG_MIN is excluded so that
+/// negating an inline value never overflows.)
+class Integer {
+private:
+  /// The value if held inline; otherwise, the sign (-1 or +1) of the value
+  long m_small;
+  /// The magnitude of values outside the inline range; null otherwise
+  IntegerRep *m_rep;
 
-// True if REP is staticly (or manually) allocated,
-// and should not be deleted by an Integer destructor.
-#define STATIC_IntegerRep(rep) ((rep)->sz==0)
-
-extern IntegerRep*  Ialloc(IntegerRep*, const unsigned short *, int, int, int);
-extern IntegerRep*  Icalloc(IntegerRep*, int);
-extern IntegerRep*  Icopy_ulong(IntegerRep*, unsigned long);
-extern IntegerRep*  Icopy_long(IntegerRep*, long);
-extern IntegerRep*  Icopy(IntegerRep*, const IntegerRep*);
-extern IntegerRep*  Iresize(IntegerRep*, int);
-extern IntegerRep*  add(const IntegerRep*, int, const IntegerRep*, int, IntegerRep*);
-extern IntegerRep*  add(const IntegerRep*, int, long, IntegerRep*);
-extern IntegerRep*  multiply(const IntegerRep*, const IntegerRep*, IntegerRep*);
-extern IntegerRep*  multiply(const IntegerRep*, long, IntegerRep*);
-extern IntegerRep*  lshift(const IntegerRep*, long, IntegerRep*);
-extern IntegerRep*  lshift(const IntegerRep*, const IntegerRep*, int, IntegerRep*);
-extern IntegerRep*  bitop(const IntegerRep*, const IntegerRep*, IntegerRep*, char);
-extern IntegerRep*  bitop(const IntegerRep*, long, IntegerRep*, char);
-extern IntegerRep*  power(const IntegerRep*, long, IntegerRep*);
-extern IntegerRep*  div(const IntegerRep*, const IntegerRep*, IntegerRep*);
-extern IntegerRep*  mod(const IntegerRep*, const IntegerRep*, IntegerRep*);
-extern IntegerRep*  div(const IntegerRep*, long, IntegerRep*);
-extern IntegerRep*  mod(const IntegerRep*, long, IntegerRep*);
-extern IntegerRep*  Compl(const IntegerRep*, IntegerRep*);
-extern IntegerRep*  abs(const IntegerRep*, IntegerRep*);
-extern IntegerRep*  negate(const IntegerRep*, IntegerRep*);
-extern IntegerRep*  gcd(const IntegerRep*, const IntegerRep* y);
-extern int      compare(const IntegerRep*, const IntegerRep*);
-extern int      compare(const IntegerRep*, long);
-extern int      ucompare(const IntegerRep*, const IntegerRep*);
-extern int      ucompare(const IntegerRep*, long);
-extern std::string Itoa(const IntegerRep* x, int base = 10, int width = 0);
-extern std::string cvtItoa(const IntegerRep* x, std::string fmt, int& fmtlen, int base,
-                           int showbase, int width, int align_right, 
-                           char fillchar, char Xcase, int showpos);
-extern IntegerRep*  atoIntegerRep(const char* s, int base = 10);
-extern long     Itolong(const IntegerRep*);
-extern double   Itodouble(const IntegerRep*);
-extern int      Iislong(const IntegerRep*);
-extern int      Iisdouble(const IntegerRep*);
-extern long     lg(const IntegerRep*);
+  /// @name Word arithmetic with overflow checks
+  //@{
+  /// Sets r = x + y, returning false if the sum is not in the inline range
+  static bool AddSmall(long x, long y, long &r);
+  /// Sets r = x - y, returning false if the difference is not in the inline range
+  static bool SubSmall(long x, long y, long &r);
+  /// Sets r = x * y, returning false if the product is not in the inline range
+  static bool MulSmall(long x, long y, long &r);
+  //@}
 
-class Integer {
-protected:
-  IntegerRep *rep;
+  /// @name Management of the out-of-line representation
+  //@{
+  static IntegerRep *CopyRep(const IntegerRep *);
+  static void FreeRep(IntegerRep *);
+  /// Sets the object to the inline value v
+  void SetSmall(long v)
+  { if (m_rep) { FreeRep(m_rep); m_rep = 0; }  m_small = v; }
+  /// Sets the object to a copy of the large value held by x
+  void AssignLarge(const Integer &x);
+  /// Sets the object to v, which may be LONG_MIN
+  void AssignLong(long v);
+  /// Sets the object to v, which may exceed LONG_MAX
+  void AssignUnsigned(unsigned long v);
+  /// Returns the magnitude of x, filling in p_buffer if x is inline
+  static const IntegerRep &GetMagnitude(const Integer &x,
+					IntegerRep &p_buffer);
+  /// Sets the object to the value of the sign and magnitude, which is consumed
+  void SetMagnitude(int p_sign, IntegerRep &p_magnitude);
+  //@}
+
+  /// @name General cases of arithmetic operations
+  //@{
+  static void AddLarge(const Integer &x, const Integer &y, bool p_subtract,
+		       Integer &dest);
+  static void MulLarge(const Integer &x, const Integer &y, Integer &dest);
+  static void DivideLarge(const Integer &x, const Integer &y,
+			  Integer *q, Integer *r);
+  static int CompareLarge(const Integer &x, const Integer &y,
+			  bool p_magnitude);
+  //@}
 
 public:
   /// @name Lifecycle
   //@{
-  Integer(void);
-  Integer(int);
-  Integer(long);
-  Integer(unsigned long);
-  Integer(IntegerRep *);
-  Integer(const Integer &);
-  ~Integer();
-
-  Integer &operator=(const Integer &);
-  Integer &operator=(long);
+  Integer(void) : m_small(0), m_rep(0) { }
+  Integer(int v) : m_small(v), m_rep(0)
+  { if (m_small == LONG_MIN) AssignLong(v); }
+  Integer(long v) : m_small(v), m_rep(0)
+  { if (v == LONG_MIN) AssignLong(v); }
+  Integer(unsigned long v) : m_small(0), m_rep(0)
+  { if (v <= (unsigned long) LONG_MAX) m_small = (long) v; else AssignUnsigned(v); }
+  Integer(const Integer &x)
+    : m_small(x.m_small), m_rep((x.m_rep) ? CopyRep(x.m_rep) : 0) { }
+  ~Integer() { if (m_rep) FreeRep(m_rep); }
+
+  Integer &operator=(const Integer &x)
+  { if (!x.m_rep) SetSmall(x.m_small); else if (this != &x) AssignLarge(x);
+    return *this; }
+  Integer &operator=(long v)
+  { if (v != LONG_MIN) SetSmall(v); else AssignLong(v);  return *this; }
   //@}
 
-
   /// @name Unary operations on self
   //@{
   void operator ++ ();
   void operator -- ();
-  void negate();          // negate in-place
-  void abs();             // absolute-value in-place
-  //@{
+  /// Negates in place
+  void negate() { m_small = -m_small; }
+  /// Takes the absolute value in place
+  void abs() { if (m_small < 0) m_small = -m_small; }
+  //@}
 
   /// @name Comparison operators
   //@{
@@ -175,15 +190,10 @@ public:
   friend int      odd(const Integer&); // true if odd
   friend int      sign(const Integer&); // returns -1, 0, +1
 
-  friend void     setbit(Integer& x, long b);   // set b'th bit of x
-  friend void     clearbit(Integer& x, long b); // clear b'th bit
-  friend int      testbit(const Integer& x, long b);  // return b'th bit
-
   // procedural versions of operators
 
   friend void     abs(const Integer& x, Integer& dest);
   friend void     negate(const Integer& x, Integer& dest);
-  friend void     complement(const Integer& x, Integer& dest);
 
   friend int      compare(const Integer&, const Integer&);  
   friend int      ucompare(const Integer&, const Integer&); 
@@ -218,11 +228,13 @@ public:
 
   // coercion & conversion
 
-  int             fits_in_long() const { return Iislong(rep); }
-  int             fits_in_double() const { return Iisdouble(rep); }
+  int             fits_in_long() const { return (m_rep == 0); }
+  int             fits_in_double() const;
 
-  long		  as_long() const { return Itolong(rep); }
-  double	  as_double() const { return Itodouble(rep); }
+  /// Returns the value, saturated to [LONG_MIN, LONG_MAX]
+  long		  as_long() const
+  { return (!m_rep) ? m_small : ((m_small > 0) ? LONG_MAX : LONG_MIN); }
+  double	  as_double() const;
 
   friend std::string Itoa(const Integer &x, int base /*= 10*/, int width /*= 0*/);
   friend Integer atoI(const char *s, int base/*= 10*/);
@@ -232,21 +244,284 @@ public:
 
   // error detection
 
-  int             initialized() const;
-  void   error(const char* msg) const;
   int             OK() const;  
 };
 
+//
+// Overflow checks use the compiler builtins where available; otherwise,
+// the operands are compared against the bounds of the inline range.
+//
+#if (defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__)
 
-//  (These are declared inline)
+inline bool Integer::AddSmall(long x, long y, long &r)
+{ return !__builtin_add_overflow(x, y, &r) && r != LONG_MIN; }
 
-Integer  abs(const Integer&); // absolute value
-Integer  sqr(const Integer&); // square
+inline bool Integer::SubSmall(long x, long y, long &r)
+{ return !__builtin_sub_overflow(x, y, &r) && r != LONG_MIN; }
 
-Integer  pow(const Integer& x, const Integer& y);
-Integer  pow(const Integer& x, long y);
-Integer  Ipow(long x, long y); // x to the y as Integer 
+inline bool Integer::MulSmall(long x, long y, long &r)
+{ return !__builtin_mul_overflow(x, y, &r) && r != LONG_MIN; }
 
+#else
+
+inline bool Integer::AddSmall(long x, long y, long &r)
+{
+  if ((y > 0 && x > LONG_MAX - y) || (y < 0 && x < -LONG_MAX - y)) {
+    return false;
+  }
+  r = x + y;
+  return true;
+}
+
+inline bool Integer::SubSmall(long x, long y, long &r)
+{ return AddSmall(x, -y, r); }
+
+inline bool Integer::MulSmall(long x, long y, long &r)
+{
+  if (x != 0 && y != 0 && 
+      ((x < 0) ? -x : x) > LONG_MAX / ((y < 0) ? -y : y)) {
+    return false;
+  }
+  r = x * y;
+  return true;
+}
+
+#endif  // __GNUC__ >= 5 || __clang__
+
+inline int sign(const Integer &x)
+{ return (x.m_small > 0) - (x.m_small < 0); }
+
+inline int compare(const Integer &x, const Integer &y)
+{
+  if (!x.m_rep && !y.m_rep) {
+    return (x.m_small > y.m_small) - (x.m_small < y.m_small);
+  }
+  return Integer::CompareLarge(x, y, false);
+}
+
+inline int ucompare(const Integer &x, const Integer &y)
+{
+  if (!x.m_rep && !y.m_rep) {
+    long a = (x.m_small < 0) ? -x.m_small : x.m_small;
+    long b = (y.m_small < 0) ? -y.m_small : y.m_small;
+    return (a > b) - (a < b);
+  }
+  return Integer::CompareLarge(x, y, true);
+}
+
+inline void add(const Integer &x, const Integer &y, Integer &dest)
+{
+  long r;
+  if (!x.m_rep && !y.m_rep && Integer::AddSmall(x.m_small, y.m_small, r)) {
+    dest.SetSmall(r);
+  }
+  else {
+    Integer::AddLarge(x, y, false, dest);
+  }
+}
+
+inline void sub(const Integer &x, const Integer &y, Integer &dest)
+{
+  long r;
+  if (!x.m_rep && !y.m_rep && Integer::SubSmall(x.m_small, y.m_small, r)) {
+    dest.SetSmall(r);
+  }
+  else {
+    Integer::AddLarge(x, y, true, dest);
+  }
+}
+
+inline void mul(const Integer &x, const Integer &y, Integer &dest)
+{
+  long r;
+  if (!x.m_rep && !y.m_rep && Integer::MulSmall(x.m_small, y.m_small, r)) {
+    dest.SetSmall(r);
+  }
+  else {
+    Integer::MulLarge(x, y, dest);
+  }
+}
+
+inline void divide(const Integer &x, const Integer &y, Integer &q, Integer &r)
+{
+  if (!x.m_rep && !y.m_rep && y.m_small != 0) {
+    long a = x.m_small, b = y.m_small;
+    q.SetSmall(a / b);
+    r.SetSmall(a % b);
+  }
+  else {
+    Integer::DivideLarge(x, y, &q, &r);
+  }
+}
+
+inline void div(const Integer &x, const Integer &y, Integer &dest)
+{
+  if (!x.m_rep && !y.m_rep && y.m_small != 0) {
+    dest.SetSmall(x.m_small / y.m_small);
+  }
+  else {
+    Integer::DivideLarge(x, y, &dest, 0);
+  }
+}
+
+inline void mod(const Integer &x, const Integer &y, Integer &dest)
+{
+  if (!x.m_rep && !y.m_rep && y.m_small != 0) {
+    dest.SetSmall(x.m_small % y.m_small);
+  }
+  else {
+    Integer::DivideLarge(x, y, 0, &dest);
+  }
+}
+
+inline void abs(const Integer &x, Integer &dest)
+{ dest = x;  dest.abs(); }
+
+inline void negate(const Integer &x, Integer &dest)
+{ dest = x;  dest.negate(); }
+
+inline void pow(const Integer &x, const Integer &y, Integer &dest)
+{ pow(x, y.as_long(), dest); }
+
+inline int compare(const Integer &x, long y)
+{ return compare(x, Integer(y)); }
+
+inline int ucompare(const Integer &x, long y)
+{ return ucompare(x, Integer(y)); }
+
+inline void add(const Integer &x, long y, Integer &dest)
+{ add(x, Integer(y), dest); }
+
+inline void sub(const Integer &x, long y, Integer &dest)
+{ sub(x, Integer(y), dest); }
+
+inline void mul(const Integer &x, long y, Integer &dest)
+{ mul(x, Integer(y), dest); }
+
+inline void div(const Integer &x, long y, Integer &dest)
+{ div(x, Integer(y), dest); }
+
+inline void mod(const Integer &x, long y, Integer &dest)
+{ mod(x, Integer(y), dest); }
+
+inline int compare(long x, const Integer &y)
+{ return compare(Integer(x), y); }
+
+inline int ucompare(long x, const Integer &y)
+{ return ucompare(Integer(x), y); }
+
+inline void add(long x, const Integer &y, Integer &dest)
+{ add(Integer(x), y, dest); }
+
+inline void sub(long x, const Integer &y, Integer &dest)
+{ sub(Integer(x), y, dest); }
+
+inline void mul(long x, const Integer &y, Integer &dest)
+{ mul(Integer(x), y, dest); }
+
+inline void Integer::operator++()  { add(*this, 1L, *this); }
+inline void Integer::operator--()  { sub(*this, 1L, *this); }
+
+inline bool Integer::operator==(const Integer &y) const
+{ return compare(*this, y) == 0; }
+inline bool Integer::operator==(long y) const
+{ return compare(*this, y) == 0; }
+inline bool Integer::operator!=(const Integer &y) const
+{ return compare(*this, y) != 0; }
+inline bool Integer::operator!=(long y) const
+{ return compare(*this, y) != 0; }
+inline bool Integer::operator<(const Integer &y) const
+{ return compare(*this, y) < 0; }
+inline bool Integer::operator<(long y) const
+{ return compare(*this, y) < 0; }
+inline bool Integer::operator<=(const Integer &y) const
+{ return compare(*this, y) <= 0; }
+inline bool Integer::operator<=(long y) const
+{ return compare(*this, y) <= 0; }
+inline bool Integer::operator>(const Integer &y) const
+{ return compare(*this, y) > 0; }
+inline bool Integer::operator>(long y) const
+{ return compare(*this, y) > 0; }
+inline bool Integer::operator>=(const Integer &y) const
+{ return compare(*this, y) >= 0; }
+inline bool Integer::operator>=(long y) const
+{ return compare(*this, y) >= 0; }
+
+inline Integer &Integer::operator+=(const Integer &y)
+{ add(*this, y, *this);  return *this; }
+inline Integer &Integer::operator-=(const Integer &y)
+{ sub(*this, y, *this);  return *this; }
+inline Integer &Integer::operator*=(const Integer &y)
+{ mul(*this, y, *this);  return *this; }
+inline Integer &Integer::operator/=(const Integer &y)
+{ div(*this, y, *this);  return *this; }
+inline Integer &Integer::operator%=(const Integer &y)
+{ mod(*this, y, *this);  return *this; }
+inline Integer &Integer::operator<<=(const Integer &y)
+{ lshift(*this, y, *this);  return *this; }
+inline Integer &Integer::operator>>=(const Integer &y)
+{ rshift(*this, y, *this);  return *this; }
+
+inline Integer &Integer::operator+=(long y)
+{ add(*this, y, *this);  return *this; }
+inline Integer &Integer::operator-=(long y)
+{ sub(*this, y, *this);  return *this; }
+inline Integer &Integer::operator*=(long y)
+{ mul(*this, y, *this);  return *this; }
+inline Integer &Integer::operator/=(long y)
+{ div(*this, y, *this);  return *this; }
+inline Integer &Integer::operator%=(long y)
+{ mod(*this, y, *this);  return *this; }
+inline Integer &Integer::operator<<=(long y)
+{ lshift(*this, y, *this);  return *this; }
+inline Integer &Integer::operator>>=(long y)
+{ rshift(*this, y, *this);  return *this; }
+
+inline Integer Integer::operator-(void) const
+{ Integer r(*this);  r.negate();  return r; }
+inline Integer Integer::operator+(const Integer &y) const
+{ Integer r;  add(*this, y, r);  return r; }
+inline Integer Integer::operator+(long y) const
+{ Integer r;  add(*this, y, r);  return r; }
+inline Integer Integer::operator-(const Integer &y) const
+{ Integer r;  sub(*this, y, r);  return r; }
+inline Integer Integer::operator-(long y) const
+{ Integer r;  sub(*this, y, r);  return r; }
+inline Integer Integer::operator*(const Integer &y) const
+{ Integer r;  mul(*this, y, r);  return r; }
+inline Integer Integer::operator*(long y) const
+{ Integer r;  mul(*this, y, r);  return r; }
+inline Integer Integer::operator/(const Integer &y) const
+{ Integer r;  div(*this, y, r);  return r; }
+inline Integer Integer::operator/(long y) const
+{ Integer r;  div(*this, y, r);  return r; }
+inline Integer Integer::operator%(const Integer &y) const
+{ Integer r;  mod(*this, y, r);  return r; }
+inline Integer Integer::operator%(long y) const
+{ Integer r;  mod(*this, y, r);  return r; }
+inline Integer Integer::operator<<(const Integer &y) const
+{ Integer r;  lshift(*this, y, r);  return r; }
+inline Integer Integer::operator<<(long y) const
+{ Integer r;  lshift(*this, y, r);  return r; }
+inline Integer Integer::operator>>(const Integer &y) const
+{ Integer r;  rshift(*this, y, r);  return r; }
+inline Integer Integer::operator>>(long y) const
+{ Integer r;  rshift(*this, y, r);  return r; }
+
+inline Integer abs(const Integer &x) // absolute value
+{ Integer r(x);  r.abs();  return r; }
+inline Integer sqr(const Integer &x) // square
+{ Integer r;  mul(x, x, r);  return r; }
+
+inline Integer pow(const Integer &x, const Integer &y)
+{ Integer r;  pow(x, y, r);  return r; }
+inline Integer pow(const Integer &x, long y)
+{ Integer r;  pow(x, y, r);  return r; }
+inline Integer Ipow(long x, long y) // x to the y as Integer 
+{ Integer r;  pow(Integer(x), y, r);  return r; }
+
+std::string Itoa(const Integer &x, int base = 10, int width = 0);
+Integer atoI(const char *s, int base = 10);
 
 extern Integer  sqrt(const Integer&); // floor of square root
 extern Integer  lcm(const Integer& x, const Integer& y); // least common mult
@@ -254,6 +529,3 @@ extern Integer  lcm(const Integer& x, const Integer& y); // least common mult
 } // end namespace Gambit
 
 #endif // LIBGAMBIT_INTEGER_H
-
-
-
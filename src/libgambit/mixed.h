@@ -23,12 +23,16 @@
 #ifndef LIBGAMBIT_MIXED_H
 #define LIBGAMBIT_MIXED_H
 
+#include <vector>
 #include "vector.h"
+#include "matrix.h"
 #include "gameagg.h"
 #include "gamebagg.h"
 
 namespace Gambit {
 
+class GameTableRep;
+
 template <class T> class MixedStrategyProfileRep {
 public:
   Vector<T> m_probs;
@@ -50,6 +54,7 @@ public:
   virtual T GetPayoff(int pl) const = 0;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &) const = 0;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const = 0;
+  virtual void GetPayoffDerivs(int pl, Matrix<T> &) const;
 };
 
 template <class T> class TreeMixedStrategyProfileRep 
@@ -70,21 +75,45 @@ public:
 template <class T> class TableMixedStrategyProfileRep
   : public MixedStrategyProfileRep<T> {
 private:
-  /// @name Private recursive payoff functions
+  /// @name Cached payoff computations
+  //@{
+  /// Number of strategies of each player in the game, and offset strides
+  mutable std::vector<int> m_dims;
+  mutable std::vector<long> m_strides;
+  /// Global index (id - 1) of the first strategy of each player
+  mutable std::vector<int> m_firstIds;
+  /// Probability of each strategy in the game, indexed by id - 1
+  mutable std::vector<T> m_fullProbs;
+  /// Expected payoff to each player
+  mutable std::vector<T> m_payoffs;
+  /// Payoff derivatives, indexed by (pl - 1) * (strategies) + (id - 1)
+  mutable std::vector<T> m_derivs;
+  /// Product distributions over the first k players, for k = 0..n-1
+  mutable std::vector<T> m_weights;
+  /// Two buffers holding partially contracted payoff tensors
+  mutable std::vector<T> m_work[2];
+  /// The payoff version of the game at which the cache was computed
+  mutable long m_version;
+  /// Are the cached product distributions current?
+  mutable bool m_cacheValid;
+  /// Are the cached payoff and derivatives of each player current?
+  mutable std::vector<bool> m_playerValid;
+  //@}
+
+  /// @name Private payoff computation functions
   //@{
-  /// Recursive computation of payoff to player pl
-  T GetPayoff(int pl, int index, int i) const;
-  /// Recursive computation of payoff derivative
-  void GetPayoffDeriv(int pl, int const_pl, int cur_pl, long index,
-		      const T &prob, T &value) const;
-  /// Recursive computation of payoff second derivative
-  void GetPayoffDeriv(int pl, int const_pl1, int const_pl2, 
-		      int cur_pl, long index, const T &prob, T &value) const;
+  /// Brings the strategy probabilities in the cache up to date
+  void UpdateCache(const GameTableRep &) const;
+  /// Computes the payoff and derivatives of a player in one pass, if not current
+  void ComputePayoffs(int pl) const;
   //@}
 
 public:
   TableMixedStrategyProfileRep(const StrategySupport &p_support)
-    : MixedStrategyProfileRep<T>(p_support)
+    : MixedStrategyProfileRep<T>(p_support), m_version(0), m_cacheValid(false)
+  { }
+  TableMixedStrategyProfileRep(const TableMixedStrategyProfileRep<T> &p_rep)
+    : MixedStrategyProfileRep<T>(p_rep), m_version(0), m_cacheValid(false)
   { }
   virtual ~TableMixedStrategyProfileRep() { }
 
@@ -92,6 +121,7 @@ public:
   virtual T GetPayoff(int pl) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const;
+  virtual void GetPayoffDerivs(int pl, Matrix<T> &) const;
 };
 
 template <class T> class AggMixedStrategyProfileRep
@@ -237,6 +267,16 @@ public:
   T GetPayoffDeriv(int pl, const GameStrategy &s1, const GameStrategy &s2) const
   { return m_rep->GetPayoffDeriv(pl, s1, s2); }
 
+  /// \brief Computes the block of second derivatives of the player's payoff
+  ///
+  /// Computes the second derivatives of the payoff to player 'pl' with
+  /// respect to the probability of each of the player's strategies and
+  /// each strategy in the profile.  Row i corresponds to the player's ith
+  /// strategy in the support, and column j to the jth entry of the profile.
+  /// The matrix is reallocated only if its dimensions do not match.
+  void GetPayoffDerivs(int pl, Matrix<T> &p_derivs) const
+  { m_rep->GetPayoffDerivs(pl, p_derivs); }
+
   /// Computes the payoff to playing the pure strategy against the profile
   T GetPayoff(const GameStrategy &p_strategy) const
   { return GetPayoffDeriv(p_strategy->GetPlayer()->GetNumber(), p_strategy); }
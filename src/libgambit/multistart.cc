@@ -0,0 +1,247 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/multistart.cc
+// Running independent starts of a solver on a pool of threads
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cmath>
+#include <stdexcept>
+#include "multistart.h"
+
+namespace Gambit {
+
+//===========================================================================
+//                        class MultiStartOutput
+//===========================================================================
+
+void MultiStartOutput::Close(void)
+{
+  std::string text = m_stream.str();
+  if (!text.empty()) {
+    m_items.push_back(Item());
+    m_items.back().m_text = text;
+    m_stream.str("");
+  }
+}
+
+void MultiStartOutput::AddEquilibrium(const std::vector<double> &p_profile,
+				      const std::string &p_text)
+{
+  Close();
+  m_items.push_back(Item());
+  m_items.back().m_text = p_text;
+  m_items.back().m_profile = p_profile;
+}
+
+//===========================================================================
+//                        class MultiStartRunner
+//===========================================================================
+
+class MultiStartRunner::Thread {
+public:
+#ifdef HAVE_PTHREAD_H
+  pthread_t m_thread;
+#endif  // HAVE_PTHREAD_H
+  MultiStartRunner *m_runner;
+  MultiStartWorker *m_worker;
+
+  void Run(void) { m_runner->RunWorker(m_worker); }
+};
+
+}  // end namespace Gambit
+
+#ifdef HAVE_PTHREAD_H
+extern "C" void *RunMultiStartThread(void *p_thread)
+{
+  static_cast<Gambit::MultiStartRunner::Thread *>(p_thread)->Run();
+  return 0;
+}
+#endif  // HAVE_PTHREAD_H
+
+namespace Gambit {
+
+//---------------------------------------------------------------------------
+//                               Lifecycle
+//---------------------------------------------------------------------------
+
+MultiStartRunner::MultiStartRunner(std::ostream &p_output, bool p_unique,
+				   double p_tolerance)
+  : m_output(p_output), m_unique(p_unique), m_tolerance(p_tolerance),
+    m_numStarts(0), m_nextStart(0), m_nextOutput(0)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_init(&m_mutex, 0);
+#endif  // HAVE_PTHREAD_H
+}
+
+MultiStartRunner::~MultiStartRunner()
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_destroy(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+}
+
+//---------------------------------------------------------------------------
+//                          Running the starts
+//---------------------------------------------------------------------------
+
+void MultiStartRunner::Run(int p_numStarts,
+			   const std::vector<MultiStartWorker *> &p_workers)
+{
+  m_numStarts = p_numStarts;
+  m_nextStart = m_nextOutput = 0;
+  m_error = "";
+  m_results = std::vector<std::vector<MultiStartOutput::Item> >(p_numStarts);
+  m_done = std::vector<bool>(p_numStarts, false);
+  m_equilibria.clear();
+
+  std::vector<Thread> threads(p_workers.size());
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].m_runner = this;
+    threads[i].m_worker = p_workers[i];
+  }
+
+#ifdef HAVE_PTHREAD_H
+  // Starts are shared out as threads ask for them, so a worker whose
+  // thread cannot be created is simply left idle
+  std::vector<bool> started(threads.size(), false);
+  for (size_t i = 1; i < threads.size(); i++) {
+    started[i] = (pthread_create(&threads[i].m_thread, 0,
+				 RunMultiStartThread, &threads[i]) == 0);
+  }
+  if (!threads.empty()) {
+    threads[0].Run();
+  }
+  for (size_t i = 1; i < threads.size(); i++) {
+    if (started[i]) {
+      pthread_join(threads[i].m_thread, 0);
+    }
+  }
+#else
+  if (!threads.empty()) {
+    threads[0].Run();
+  }
+#endif  // HAVE_PTHREAD_H
+
+  if (!m_error.empty()) {
+    throw std::runtime_error(m_error);
+  }
+}
+
+void MultiStartRunner::RunWorker(MultiStartWorker *p_worker)
+{
+  int start;
+  while ((start = NextStart()) >= 0) {
+    MultiStartOutput output;
+    try {
+      p_worker->Run(start, output);
+    }
+    catch (std::exception &e) {
+      Fail(e.what());
+      return;
+    }
+    catch (...) {
+      Fail("An internal error occurred");
+      return;
+    }
+    Finish(start, output);
+  }
+}
+
+//---------------------------------------------------------------------------
+//                      Scheduling and collecting output
+//---------------------------------------------------------------------------
+
+int MultiStartRunner::NextStart(void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+  int start = -1;
+  if (m_error.empty() && m_nextStart < m_numStarts) {
+    start = m_nextStart++;
+  }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+  return start;
+}
+
+void MultiStartRunner::Finish(int p_start, MultiStartOutput &p_output)
+{
+  p_output.Close();
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+  m_results[p_start].swap(p_output.m_items);
+  m_done[p_start] = true;
+  while (m_nextOutput < m_numStarts && m_done[m_nextOutput]) {
+    Write(m_results[m_nextOutput]);
+    m_results[m_nextOutput++].clear();
+  }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+}
+
+void MultiStartRunner::Fail(const std::string &p_message)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+  if (m_error.empty()) {
+    m_error = p_message;
+  }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock(&m_mutex);
+#endif  // HAVE_PTHREAD_H
+}
+
+bool MultiStartRunner::IsRepeated(const std::vector<double> &p_profile)
+{
+  for (size_t i = 0; i < m_equilibria.size(); i++) {
+    const std::vector<double> &other = m_equilibria[i];
+    if (other.size() != p_profile.size()) {
+      continue;
+    }
+    size_t j = 0;
+    while (j < p_profile.size() &&
+	   std::fabs(p_profile[j] - other[j]) <= m_tolerance) {
+      j++;
+    }
+    if (j == p_profile.size()) {
+      return true;
+    }
+  }
+  m_equilibria.push_back(p_profile);
+  return false;
+}
+
+void MultiStartRunner::Write(const std::vector<MultiStartOutput::Item> &p_items)
+{
+  for (size_t i = 0; i < p_items.size(); i++) {
+    if (!m_unique || p_items[i].m_profile.empty() ||
+	!IsRepeated(p_items[i].m_profile)) {
+      m_output << p_items[i].m_text;
+    }
+  }
+  m_output.flush();
+}
+
+}  // end namespace Gambit
@@ -0,0 +1,155 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/multistart.h
+// Running independent starts of a solver on a pool of threads
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_MULTISTART_H
+#define LIBGAMBIT_MULTISTART_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "libgambit.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif  // HAVE_PTHREAD_H
+
+namespace Gambit {
+
+/// \brief The output of one start of a solver
+///
+/// A start writes its output to the stream, except for the equilibria
+/// it finds, which it reports with AddEquilibrium(), giving both the
+/// equilibrium and the text to write for it.  The two are written in the
+/// order in which they were given.
+class MultiStartOutput {
+private:
+  /// A block of text, which is an equilibrium if the profile is not empty
+  struct Item {
+    std::string m_text;
+    std::vector<double> m_profile;
+  };
+
+  std::ostringstream m_stream;
+  std::vector<Item> m_items;
+
+  friend class MultiStartRunner;
+
+  /// Ends the current block of text written to the stream
+  void Close(void);
+
+public:
+  /// The stream for output other than equilibria
+  std::ostream &GetStream(void) { return m_stream; }
+  /// Reports an equilibrium, with the text to write for it
+  void AddEquilibrium(const std::vector<double> &p_profile,
+		      const std::string &p_text);
+};
+
+/// \brief The state one thread needs to run starts of a solver
+///
+/// Game objects use reference counts which are not safe to update from
+/// more than one thread, so each worker should own what its starts use,
+/// typically a copy of the game made with Game::Copy().  Starting points
+/// should be prepared in advance, so that they do not depend on the
+/// thread or the order in which starts are run.
+class MultiStartWorker {
+public:
+  virtual ~MultiStartWorker() { }
+
+  /// Runs the start with the given (zero-based) index, reporting its
+  /// output and the equilibria it finds
+  virtual void Run(int p_start, MultiStartOutput &p_output) = 0;
+};
+
+/// \brief Runs independent starts of a solver on a pool of threads
+///
+/// Each worker is run on a thread of its own, taking the next start not
+/// yet taken until all have been run.  The output of each start is
+/// collected separately, and is written to the output stream in start
+/// order as soon as the starts before it are complete, so the output does
+/// not depend on the number of threads.  Optionally, an equilibrium which
+/// repeats one written by an earlier start is dropped.  Two equilibria
+/// are taken to be the same if none of their probabilities differ by more
+/// than a tolerance, so that the same equilibrium reached from different
+/// starts is recognized even if it is not computed identically.
+///
+/// If a start throws an exception, no further starts are begun, and
+/// Run() throws std::runtime_error with its message once the running
+/// starts have finished.
+class MultiStartRunner {
+private:
+  std::ostream &m_output;
+  bool m_unique;
+  double m_tolerance;
+  int m_numStarts, m_nextStart, m_nextOutput;
+  /// The message of the first exception thrown by a start
+  std::string m_error;
+  /// The output of the starts completed out of order
+  std::vector<std::vector<MultiStartOutput::Item> > m_results;
+  std::vector<bool> m_done;
+  /// The equilibria written so far
+  std::vector<std::vector<double> > m_equilibria;
+#ifdef HAVE_PTHREAD_H
+  /// Held while taking a start or recording its output
+  pthread_mutex_t m_mutex;
+#endif  // HAVE_PTHREAD_H
+
+  friend class Thread;
+
+  /// @name Copying is not permitted
+  //@{
+  MultiStartRunner(const MultiStartRunner &);
+  MultiStartRunner &operator=(const MultiStartRunner &);
+  //@}
+
+  /// Returns the index of the next start to run, or -1 if none remain
+  int NextStart(void);
+  /// Records the output of a start, writing any output now in order
+  void Finish(int p_start, MultiStartOutput &p_output);
+  /// Records the message of an exception thrown by a start
+  void Fail(const std::string &p_message);
+  /// Returns true if the equilibrium repeats one written earlier,
+  /// recording it otherwise
+  bool IsRepeated(const std::vector<double> &p_profile);
+  /// Writes the output of a start to the output stream
+  void Write(const std::vector<MultiStartOutput::Item> &p_items);
+  /// Runs starts on the worker until none remain
+  void RunWorker(MultiStartWorker *p_worker);
+
+public:
+  /// One thread of the pool; defined in the implementation
+  class Thread;
+
+  /// @name Lifecycle
+  //@{
+  MultiStartRunner(std::ostream &p_output, bool p_unique = false,
+		   double p_tolerance = 1.0e-4);
+  ~MultiStartRunner();
+  //@}
+
+  /// Runs p_numStarts starts, one thread per worker
+  void Run(int p_numStarts, const std::vector<MultiStartWorker *> &p_workers);
+};
+
+}  // end namespace Gambit
+
+#endif  // LIBGAMBIT_MULTISTART_H
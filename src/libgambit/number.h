@@ -39,6 +39,10 @@ public:
     : m_text(p_text), m_rational(lexical_cast<Rational>(p_text)), 
       m_double((double) m_rational)
   { }
+  /// Constructs the number from its text and the value the text denotes
+  Number(const std::string &p_text, const Rational &p_value)
+    : m_text(p_text), m_rational(p_value), m_double((double) m_rational)
+  { }
   
   Number &operator=(const std::string &p_text)
   {
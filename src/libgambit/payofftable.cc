@@ -0,0 +1,217 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/payofftable.cc
+// Vectorized contraction of dense payoff tables
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include "payofftable.h"
+
+//
+// Vector implementations are provided for x86 processors when compiling
+// with GCC or clang, which allow individual functions to be compiled for
+// instruction sets beyond those enabled for the translation unit.  The
+// best implementation the processor supports is chosen on first use.
+//
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define GAMBIT_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace Gambit {
+
+namespace {
+
+typedef void (*ContractFunction)(const double *, long, int,
+				 const double *, const double *,
+				 double *, double *);
+
+void ContractScalar(const double *p_tensor, long p_stride, int p_dim,
+		    const double *p_probs, const double *p_weights,
+		    double *p_out, double *p_derivs)
+{
+  for (long a = 0; a < p_stride; a++) {
+    p_out[a] = 0.0;
+  }
+  for (int s = 0; s < p_dim; s++) {
+    const double prob = p_probs[s];
+    const double *block = p_tensor + s * p_stride;
+    if (p_weights) {
+      double deriv = 0.0;
+      if (prob != 0.0) {
+	for (long a = 0; a < p_stride; a++) {
+	  deriv += p_weights[a] * block[a];
+	  p_out[a] += prob * block[a];
+	}
+      }
+      else {
+	for (long a = 0; a < p_stride; a++) {
+	  deriv += p_weights[a] * block[a];
+	}
+      }
+      p_derivs[s] = deriv;
+    }
+    else if (prob != 0.0) {
+      for (long a = 0; a < p_stride; a++) {
+	p_out[a] += prob * block[a];
+      }
+    }
+  }
+}
+
+#ifdef GAMBIT_X86_KERNELS
+
+__attribute__((target("avx2,fma")))
+void ContractAVX2(const double *p_tensor, long p_stride, int p_dim,
+		  const double *p_probs, const double *p_weights,
+		  double *p_out, double *p_derivs)
+{
+  const long vecEnd = p_stride - p_stride % 4;
+  for (long a = 0; a < p_stride; a++) {
+    p_out[a] = 0.0;
+  }
+  for (int s = 0; s < p_dim; s++) {
+    const double prob = p_probs[s];
+    const double *block = p_tensor + s * p_stride;
+    const __m256d vprob = _mm256_set1_pd(prob);
+    if (p_weights) {
+      __m256d acc = _mm256_setzero_pd();
+      long a = 0;
+      if (prob != 0.0) {
+	for (; a < vecEnd; a += 4) {
+	  __m256d x = _mm256_loadu_pd(block + a);
+	  acc = _mm256_fmadd_pd(_mm256_loadu_pd(p_weights + a), x, acc);
+	  _mm256_storeu_pd(p_out + a,
+			   _mm256_fmadd_pd(vprob, x, _mm256_loadu_pd(p_out + a)));
+	}
+      }
+      else {
+	for (; a < vecEnd; a += 4) {
+	  acc = _mm256_fmadd_pd(_mm256_loadu_pd(p_weights + a),
+				_mm256_loadu_pd(block + a), acc);
+	}
+      }
+      __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc),
+				_mm256_extractf128_pd(acc, 1));
+      double deriv = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+      for (; a < p_stride; a++) {
+	deriv += p_weights[a] * block[a];
+	if (prob != 0.0) {
+	  p_out[a] += prob * block[a];
+	}
+      }
+      p_derivs[s] = deriv;
+    }
+    else if (prob != 0.0) {
+      long a = 0;
+      for (; a < vecEnd; a += 4) {
+	_mm256_storeu_pd(p_out + a,
+			 _mm256_fmadd_pd(vprob, _mm256_loadu_pd(block + a),
+					 _mm256_loadu_pd(p_out + a)));
+      }
+      for (; a < p_stride; a++) {
+	p_out[a] += prob * block[a];
+      }
+    }
+  }
+}
+
+__attribute__((target("avx512f")))
+void ContractAVX512(const double *p_tensor, long p_stride, int p_dim,
+		    const double *p_probs, const double *p_weights,
+		    double *p_out, double *p_derivs)
+{
+  const long vecEnd = p_stride - p_stride % 8;
+  for (long a = 0; a < p_stride; a++) {
+    p_out[a] = 0.0;
+  }
+  for (int s = 0; s < p_dim; s++) {
+    const double prob = p_probs[s];
+    const double *block = p_tensor + s * p_stride;
+    const __m512d vprob = _mm512_set1_pd(prob);
+    if (p_weights) {
+      __m512d acc = _mm512_setzero_pd();
+      long a = 0;
+      if (prob != 0.0) {
+	for (; a < vecEnd; a += 8) {
+	  __m512d x = _mm512_loadu_pd(block + a);
+	  acc = _mm512_fmadd_pd(_mm512_loadu_pd(p_weights + a), x, acc);
+	  _mm512_storeu_pd(p_out + a,
+			   _mm512_fmadd_pd(vprob, x, _mm512_loadu_pd(p_out + a)));
+	}
+      }
+      else {
+	for (; a < vecEnd; a += 8) {
+	  acc = _mm512_fmadd_pd(_mm512_loadu_pd(p_weights + a),
+				_mm512_loadu_pd(block + a), acc);
+	}
+      }
+      double lanes[8];
+      _mm512_storeu_pd(lanes, acc);
+      double deriv = (((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+		      ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7])));
+      for (; a < p_stride; a++) {
+	deriv += p_weights[a] * block[a];
+	if (prob != 0.0) {
+	  p_out[a] += prob * block[a];
+	}
+      }
+      p_derivs[s] = deriv;
+    }
+    else if (prob != 0.0) {
+      long a = 0;
+      for (; a < vecEnd; a += 8) {
+	_mm512_storeu_pd(p_out + a,
+			 _mm512_fmadd_pd(vprob, _mm512_loadu_pd(block + a),
+					 _mm512_loadu_pd(p_out + a)));
+      }
+      for (; a < p_stride; a++) {
+	p_out[a] += prob * block[a];
+      }
+    }
+  }
+}
+
+#endif  // GAMBIT_X86_KERNELS
+
+ContractFunction SelectContract(void)
+{
+#ifdef GAMBIT_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return ContractAVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return ContractAVX2;
+  }
+#endif  // GAMBIT_X86_KERNELS
+  return ContractScalar;
+}
+
+}  // end anonymous namespace
+
+void ContractPayoffs(const double *p_tensor, long p_stride, int p_dim,
+		     const double *p_probs, const double *p_weights,
+		     double *p_out, double *p_derivs)
+{
+  static const ContractFunction contract = SelectContract();
+  contract(p_tensor, p_stride, p_dim, p_probs, p_weights, p_out, p_derivs);
+}
+
+}  // end namespace Gambit
@@ -0,0 +1,127 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/payofftable.h
+// A dense, contiguous table of payoffs for a strategic game
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_PAYOFFTABLE_H
+#define LIBGAMBIT_PAYOFFTABLE_H
+
+#include <cstddef>
+#include <new>
+
+namespace Gambit {
+
+/// \brief A dense table of payoffs over the contingencies of a game
+///
+/// The payoffs are stored player-major in a single contiguous block,
+/// whose start is aligned to a cache line.  The payoffs to one player
+/// occupy a run of NumContingencies() consecutive entries, indexed by
+/// the sum of the offsets of the strategies in the contingency.  Since
+/// the strategy offsets are zero-based, entry i of the run corresponds to
+/// the contingency with table index i+1.
+template <class T> class PayoffTable {
+private:
+  int m_numPlayers;
+  long m_numContingencies;
+  char *m_block;
+  T *m_data;
+
+  /// @name Disallowed copying
+  //@{
+  PayoffTable(const PayoffTable<T> &);
+  PayoffTable<T> &operator=(const PayoffTable<T> &);
+  //@}
+
+public:
+  /// The alignment, in bytes, of the first entry of the table
+  static const size_t Alignment = 64;
+
+  /// @name Lifecycle
+  //@{
+  /// Constructs an empty table
+  PayoffTable(void)
+    : m_numPlayers(0), m_numContingencies(0L), m_block(0), m_data(0) { }
+  /// Destructs the table and releases its storage
+  ~PayoffTable() { Clear(); }
+
+  /// Allocates a table of the given dimensions, with all payoffs zero
+  void Resize(int p_numPlayers, long p_numContingencies)
+  {
+    Clear();
+    size_t size = (size_t) p_numPlayers * (size_t) p_numContingencies;
+    m_block = new char[size * sizeof(T) + Alignment];
+    m_data = reinterpret_cast<T *>(m_block + Alignment -
+				   reinterpret_cast<size_t>(m_block) % Alignment);
+    for (size_t i = 0; i < size; i++) {
+      new (m_data + i) T(0);
+    }
+    m_numPlayers = p_numPlayers;
+    m_numContingencies = p_numContingencies;
+  }
+  /// Releases the storage of the table, leaving it empty
+  void Clear(void)
+  {
+    size_t size = (size_t) m_numPlayers * (size_t) m_numContingencies;
+    for (size_t i = 0; i < size; i++) {
+      m_data[i].~T();
+    }
+    delete [] m_block;
+    m_block = 0;
+    m_data = 0;
+    m_numPlayers = 0;
+    m_numContingencies = 0L;
+  }
+  //@}
+
+  /// @name Data access
+  //@{
+  /// Returns true if the table has no storage allocated
+  bool IsEmpty(void) const { return (m_data == 0); }
+  /// Returns the number of players
+  int NumPlayers(void) const { return m_numPlayers; }
+  /// Returns the number of contingencies
+  long NumContingencies(void) const { return m_numContingencies; }
+
+  /// Returns the run of payoffs to player pl, indexed by offset sum
+  const T *GetPayoffs(int pl) const
+  { return m_data + (size_t) (pl - 1) * (size_t) m_numContingencies; }
+  /// Returns the run of payoffs to player pl, indexed by offset sum
+  T *GetPayoffs(int pl)
+  { return m_data + (size_t) (pl - 1) * (size_t) m_numContingencies; }
+  //@}
+};
+
+/// \brief Contracts one player out of a dense tensor of payoffs
+///
+/// The tensor holds p_dim consecutive blocks of p_stride entries, one
+/// per strategy of the player.  On return, p_out holds the sum of the
+/// blocks weighted by p_probs, and, if p_weights is not null, p_derivs[s]
+/// holds the inner product of block s with p_weights.  Blocks whose
+/// probability is zero are not added into p_out.
+///
+/// The implementation is selected at runtime according to the vector
+/// instructions supported by the processor.
+void ContractPayoffs(const double *p_tensor, long p_stride, int p_dim,
+		     const double *p_probs, const double *p_weights,
+		     double *p_out, double *p_derivs);
+
+} // end namespace Gambit
+
+#endif // LIBGAMBIT_PAYOFFTABLE_H
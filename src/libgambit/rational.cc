@@ -33,11 +33,109 @@ Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
 #include <cmath>
 #include <cfloat>
 #include <cctype>
+#include <climits>
 
 namespace Gambit {
 
 static const Integer _Int_One(1);
 
+//
+// When the compiler provides a 128-bit integer type, operations on
+// fractions whose parts all fit in a long are carried out on the parts
+// directly: products of two such parts, and sums of two such products,
+// cannot overflow 128 bits.  Results whose parts are below
+// c_reduceThreshold are stored without reducing them to lowest terms;
+// they are reduced when they grow past it, and when they are copied or
+// assigned.
+//
+#if defined(__SIZEOF_INT128__) && (ULONG_MAX > 0xffffffffUL)
+#define RATIONAL_WIDE_ARITHMETIC 1
+
+namespace {
+
+__extension__ typedef __int128 Wide;
+__extension__ typedef unsigned __int128 UWide;
+
+const UWide c_reduceThreshold = (UWide) 1 << 32;
+
+inline bool IsInline(const Integer &a, const Integer &b,
+		     const Integer &c, const Integer &d)
+{ return a.fits_in_long() && b.fits_in_long() && c.fits_in_long() && d.fits_in_long(); }
+
+inline int TrailingZeros(UWide x)
+{
+  unsigned long lo = (unsigned long) x;
+  return (lo != 0) ? __builtin_ctzl(lo) : 64 + __builtin_ctzl((unsigned long) (x >> 64));
+}
+
+/// Binary gcd of two values, not both zero
+UWide WideGcd(UWide a, UWide b)
+{
+  if (a == 0)  return b;
+  if (b == 0)  return a;
+  int shift = TrailingZeros(a | b);
+  a >>= TrailingZeros(a);
+  do {
+    b >>= TrailingZeros(b);
+    if (a > b) {
+      UWide t = a;  a = b;  b = t;
+    }
+    b -= a;
+  } while (b != 0);
+  return a << shift;
+}
+
+Integer ToInteger(UWide v, bool p_negative)
+{
+  Integer r;
+  if (v <= (UWide) LONG_MAX) {
+    r = (long) v;
+  }
+  else {
+    r = Integer((unsigned long) (v >> 64));
+    r <<= 64;
+    r += Integer((unsigned long) v);
+  }
+  if (p_negative)  r.negate();
+  return r;
+}
+
+/// Sets p_num/p_den to n/d, where d > 0, reducing if the parts are large;
+/// p_reduced is set to whether the result is known to be in lowest terms
+void SetFraction(Integer &p_num, Integer &p_den, bool &p_reduced,
+		 Wide n, Wide d)
+{
+  bool negative = (n < 0);
+  UWide un = (negative) ? -(UWide) n : (UWide) n, ud = (UWide) d;
+  if (un == 0) {
+    p_num = 0L;
+    p_den = 1L;
+    p_reduced = true;
+    return;
+  }
+  p_reduced = (ud == 1);
+  if (un >= c_reduceThreshold || ud >= c_reduceThreshold) {
+    UWide g = WideGcd(un, ud);
+    if (g != 1) {
+      un /= g;
+      ud /= g;
+    }
+    p_reduced = true;
+  }
+  if (un <= (UWide) LONG_MAX && ud <= (UWide) LONG_MAX) {
+    p_num = (negative) ? -(long) un : (long) un;
+    p_den = (long) ud;
+  }
+  else {
+    p_num = ToInteger(un, negative);
+    p_den = ToInteger(ud, false);
+  }
+}
+
+}  // end anonymous namespace
+
+#endif  // __SIZEOF_INT128__
+
 void Rational::normalize(void)
 {
   int s = sign(den);
@@ -49,15 +147,53 @@ void Rational::normalize(void)
     num.negate();
   }
 
+  // Parts which fit in a long are reduced using machine arithmetic
+  if (num.fits_in_long() && den.fits_in_long()) {
+    reduced = false;
+    Reduce();
+    return;
+  }
+
   Integer g = gcd(num, den);
   if (ucompare(g, _Int_One) != 0)  {
     num /= g;
     den /= g;
   }
+  reduced = true;
+}
+
+void Rational::Reduce(void)
+{
+  if (reduced)  return;
+  reduced = true;
+  // Reduction is only ever deferred for fractions with inline parts
+  if (num.fits_in_long() && den.fits_in_long()) {
+    long a = num.as_long(), b = den.as_long();
+    unsigned long u = (a < 0) ? -(unsigned long) a : (unsigned long) a;
+    unsigned long v = (unsigned long) b;
+    while (v != 0) {
+      unsigned long t = u % v;
+      u = v;
+      v = t;
+    }
+    if (u > 1) {
+      num = a / (long) u;
+      den = b / (long) u;
+    }
+  }
 }
 
 void      add(const Rational& x, const Rational& y, Rational& r)
 {
+#ifdef RATIONAL_WIDE_ARITHMETIC
+  if (IsInline(x.num, x.den, y.num, y.den)) {
+    SetFraction(r.num, r.den, r.reduced,
+		(Wide) x.num.as_long() * y.den.as_long() + 
+		(Wide) y.num.as_long() * x.den.as_long(),
+		(Wide) x.den.as_long() * y.den.as_long());
+    return;
+  }
+#endif  // RATIONAL_WIDE_ARITHMETIC
   if (&r != &x && &r != &y)
     {
       mul(x.num, y.den, r.num);
@@ -78,6 +214,15 @@ void      add(const Rational& x, const Rational& y, Rational& r)
 
 void      sub(const Rational& x, const Rational& y, Rational& r)
 {
+#ifdef RATIONAL_WIDE_ARITHMETIC
+  if (IsInline(x.num, x.den, y.num, y.den)) {
+    SetFraction(r.num, r.den, r.reduced,
+		(Wide) x.num.as_long() * y.den.as_long() - 
+		(Wide) y.num.as_long() * x.den.as_long(),
+		(Wide) x.den.as_long() * y.den.as_long());
+    return;
+  }
+#endif  // RATIONAL_WIDE_ARITHMETIC
   if (&r != &x && &r != &y)
     {
       mul(x.num, y.den, r.num);
@@ -98,6 +243,14 @@ void      sub(const Rational& x, const Rational& y, Rational& r)
 
 void      mul(const Rational& x, const Rational& y, Rational& r)
 {
+#ifdef RATIONAL_WIDE_ARITHMETIC
+  if (IsInline(x.num, x.den, y.num, y.den)) {
+    SetFraction(r.num, r.den, r.reduced,
+		(Wide) x.num.as_long() * y.num.as_long(),
+		(Wide) x.den.as_long() * y.den.as_long());
+    return;
+  }
+#endif  // RATIONAL_WIDE_ARITHMETIC
   mul(x.num, y.num, r.num);
   mul(x.den, y.den, r.den);
   r.normalize();
@@ -105,6 +258,21 @@ void      mul(const Rational& x, const Rational& y, Rational& r)
 
 void      div(const Rational& x, const Rational& y, Rational& r)
 {
+#ifdef RATIONAL_WIDE_ARITHMETIC
+  if (IsInline(x.num, x.den, y.num, y.den)) {
+    if (sign(y.num) == 0) {
+      throw ZeroDivideException();
+    }
+    Wide n = (Wide) x.num.as_long() * y.den.as_long();
+    Wide d = (Wide) x.den.as_long() * y.num.as_long();
+    if (d < 0) {
+      n = -n;
+      d = -d;
+    }
+    SetFraction(r.num, r.den, r.reduced, n, d);
+    return;
+  }
+#endif  // RATIONAL_WIDE_ARITHMETIC
   if (&r != &x && &r != &y)
     {
       mul(x.num, y.den, r.num);
@@ -140,6 +308,13 @@ void Rational::invert(void)
 
 int compare(const Rational& x, const Rational& y)
 {
+#ifdef RATIONAL_WIDE_ARITHMETIC
+  if (IsInline(x.num, x.den, y.num, y.den)) {
+    Wide a = (Wide) x.num.as_long() * y.den.as_long();
+    Wide b = (Wide) y.num.as_long() * x.den.as_long();
+    return (a > b) - (a < b);
+  }
+#endif  // RATIONAL_WIDE_ARITHMETIC
   int xsgn = sign(x.num);
   int ysgn = sign(y.num);
   int d = xsgn - ysgn;
@@ -255,17 +430,18 @@ Integer round(const Rational& x)
 
 Rational pow(const Rational& x, long y)
 {
-  Rational r;
+  // Powers of a fraction in lowest terms are in lowest terms
+  Rational base(x), r;
   if (y >= 0)
     {
-      pow(x.num, y, r.num);
-      pow(x.den, y, r.den);
+      pow(base.num, y, r.num);
+      pow(base.den, y, r.den);
     }
   else
     {
       y = -y;
-      pow(x.num, y, r.den);
-      pow(x.den, y, r.num);
+      pow(base.num, y, r.den);
+      pow(base.den, y, r.num);
       if (sign(r.den) < 0)
 	{
 	  r.num.negate();
@@ -275,15 +451,16 @@ Rational pow(const Rational& x, long y)
   return r;
 }
 
-std::ostream &operator << (std::ostream &s, const Rational& y)
+std::ostream &operator << (std::ostream &s, const Rational& p_value)
 {
-  if (y.denominator() == 1L)
-    s << y.numerator();
+  Rational y(p_value);
+  if (y.den == 1L)
+    s << y.num;
   else
     {
-      s << y.numerator();
+      s << y.num;
       s << "/";
-      s << y.denominator();
+      s << y.den;
     }
   return s;
 }
@@ -367,7 +544,9 @@ bool Rational::OK(void) const
   int v = num.OK() && den.OK(); // have valid num and denom
   if (v)   {
     v &= sign(den) > 0;           // denominator positive;
-    v &=  ucompare(gcd(num, den), _Int_One) == 0; // relatively prime
+    if (reduced) {
+      v &=  ucompare(gcd(num, den), _Int_One) == 0; // relatively prime
+    }
   }
   // if (!v) error("invariant failure");
   return v;
@@ -390,18 +569,19 @@ Rational::fits_in_double() const
 // These were moved from the header file to eliminate warnings
 //
 
-static IntegerRep _ZeroRep = {1, 0, 1, {0}};
-static IntegerRep _OneRep = {1, 0, 1, {1}};
-
-Rational::Rational() : num(&_ZeroRep), den(&_OneRep) {}
+Rational::Rational() : num(0L), den(1L), reduced(true) {}
 Rational::~Rational() {}
 
-Rational::Rational(const Rational& y) :num(y.num), den(y.den) {}
+Rational::Rational(const Rational& y)
+  : num(y.num), den(y.den), reduced(y.reduced)
+{
+  Reduce();
+}
 
-Rational::Rational(const Integer& n) :num(n), den(&_OneRep) {}
+Rational::Rational(const Integer& n) :num(n), den(1L), reduced(true) {}
 
 Rational::Rational(const Integer& n, const Integer& d) 
- : num(n), den(d)
+ : num(n), den(d), reduced(false)
 {
   if (d == 0)  {
     throw ZeroDivideException();
@@ -409,12 +589,12 @@ Rational::Rational(const Integer& n, const Integer& d)
   normalize();
 }
 
-Rational::Rational(long n) :num(n), den(&_OneRep) { }
+Rational::Rational(long n) :num(n), den(1L), reduced(true) { }
 
-Rational::Rational(int n) :num(n), den(&_OneRep) { }
+Rational::Rational(int n) :num(n), den(1L), reduced(true) { }
 
 Rational::Rational(long n, long d) 
- : num(n), den(d)
+ : num(n), den(d), reduced(false)
 {
   if (d == 0) {
     throw ZeroDivideException();
@@ -423,7 +603,7 @@ Rational::Rational(long n, long d)
 }
 
 Rational::Rational(int n, int d) 
- : num(n), den(d) 
+ : num(n), den(d), reduced(false)
 { 
   if (d == 0) {
     throw ZeroDivideException();
@@ -433,17 +613,29 @@ Rational::Rational(int n, int d)
 
 Rational &Rational::operator =  (const Rational& y)
 {
-  num = y.num;  den = y.den;   return *this;
+  num = y.num;  den = y.den;  reduced = y.reduced;
+  Reduce();
+  return *this;
 }
 
+//
+// Fractions with arbitrary-precision parts are always in lowest terms,
+// so they are equal exactly when their parts are; a fraction with inline
+// parts cannot equal one with a part outside that range.
+//
 bool Rational::operator==(const Rational &y) const
 {
+#ifdef RATIONAL_WIDE_ARITHMETIC
+  if (IsInline(num, den, y.num, y.den)) {
+    return compare(*this, y) == 0;
+  }
+#endif  // RATIONAL_WIDE_ARITHMETIC
   return compare(num, y.num) == 0 && compare(den, y.den) == 0;
 }
 
 bool Rational::operator!=(const Rational &y) const
 {
-  return compare(num, y.num) != 0 || compare(den, y.den) != 0;
+  return !(*this == y);
 }
 
 bool Rational::operator< (const Rational &y) const
@@ -501,8 +693,11 @@ Rational &Rational::operator/=(const Rational& y)
   return *this;
 }
 
-const Integer& Rational::numerator() const { return num; }
-const Integer& Rational::denominator() const { return den; }
+Integer Rational::numerator() const
+{ return (reduced) ? num : Rational(*this).num; }
+
+Integer Rational::denominator() const
+{ return (reduced) ? den : Rational(*this).den; }
 
 Rational::operator double(void) const 
 {
@@ -537,9 +732,60 @@ Rational Rational::operator/(const Rational &y) const
 }
 
 
+namespace {
+
+//
+// Parses the common forms of rational text in machine words: an
+// optionally negative integer, fraction, or decimal without exponent,
+// having at most 18 digits in all.  Returns false if the text has any
+// other form, which is left to the general parser.
+//
+bool ParseSmallRational(const std::string &p_text, long &p_num, long &p_den)
+{
+  const char *c = p_text.c_str();
+  while (isspace(*c))  c++;
+  bool negative = (*c == '-');
+  if (negative)  c++;
+
+  unsigned long num = 0, den = 1;
+  int digits = 0;
+  for (; *c >= '0' && *c <= '9'; c++, digits++) {
+    num = 10 * num + (*c - '0');
+  }
+  if (*c == '/') {
+    int denDigits = 0;
+    for (den = 0, c++; *c >= '0' && *c <= '9'; c++, denDigits++) {
+      den = 10 * den + (*c - '0');
+    }
+    if (digits == 0 || denDigits == 0 || den == 0) {
+      return false;
+    }
+    digits += denDigits;
+  }
+  else if (*c == '.') {
+    for (c++; *c >= '0' && *c <= '9'; c++, digits++) {
+      num = 10 * num + (*c - '0');
+      den *= 10;
+    }
+  }
+  if (*c != '\0' || digits == 0 || digits > 18) {
+    return false;
+  }
+  p_num = (negative) ? -(long) num : (long) num;
+  p_den = (long) den;
+  return true;
+}
+
+}  // end anonymous namespace
+
 template<>
 Rational lexical_cast(const std::string &f)
 {
+  long n, d;
+  if (ParseSmallRational(f, n, d)) {
+    return (d == 1) ? Rational(n) : Rational(n, d);
+  }
+
   char ch = ' ';
   int sign = 1;
   unsigned int index = 0, length = f.length();
@@ -33,12 +33,25 @@ Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
 
 namespace Gambit {
 
-/// A representation of an arbitrary-precision rational number
+/// \brief A representation of an arbitrary-precision rational number
+///
+/// When the numerator and denominator of both operands fit in a long,
+/// arithmetic is done in 128-bit intermediates where the compiler
+/// supports them, and the result is only promoted to arbitrary precision
+/// if it does not fit.  Such results are also not brought to lowest terms
+/// until they grow past a threshold, which lets sums and products be
+/// accumulated without a gcd at each step.  A fraction is brought to
+/// lowest terms when it is copied or assigned; const members never modify
+/// the object, so a Rational may be read from several threads at once.
 class Rational {
 protected:
   Integer num, den;
+  /// False if the fraction may not be in lowest terms
+  bool reduced;
 
   void normalize();
+  /// Brings the fraction to lowest terms, if reduction was deferred
+  void Reduce(void);
 
 public:
   Rational(void);
@@ -85,8 +98,8 @@ public:
   friend Rational  sqr(const Rational& x);              // square
   friend Rational  pow(const Rational& x, long y);
   friend Rational  pow(const Rational& x, const Integer& y);
-  const Integer&   numerator() const;
-  const Integer&   denominator() const;
+  Integer          numerator() const;
+  Integer          denominator() const;
 
   // coercion & conversion
 
@@ -24,6 +24,19 @@
 
 namespace Gambit {
 
+//===========================================================================
+//                       class StrategyContingency
+//===========================================================================
+
+StrategyContingency::StrategyContingency(const StrategySupport &p_support)
+  : m_strategies(p_support.GetGame()->NumPlayers()), m_index(1L)
+{
+  for (int pl = 1; pl <= m_strategies.Length(); pl++) {
+    m_strategies[pl] = p_support.GetStrategy(pl, 1);
+    m_index += m_strategies[pl]->m_offset;
+  }
+}
+
 //===========================================================================
 //                        class StrategyIterator
 //===========================================================================
@@ -34,35 +47,44 @@ namespace Gambit {
 
 StrategyIterator::StrategyIterator(const StrategySupport &p_support)
   : m_atEnd(false), m_support(p_support),
+    m_strategies(m_support.GetGame()->NumPlayers()),
     m_currentStrat(m_support.GetGame()->NumPlayers()),
+    m_contingency(m_support),
     m_profile(m_support.GetGame()->NewPureStrategyProfile()), 
     m_frozen1(0), m_frozen2(0)
 {
+  Initialize();
   First();
 }
 
 StrategyIterator::StrategyIterator(const StrategySupport &p_support,
 				   int pl, int st)
   : m_atEnd(false), m_support(p_support), 
+    m_strategies(m_support.GetGame()->NumPlayers()),
     m_currentStrat(m_support.GetGame()->NumPlayers()),
+    m_contingency(m_support),
     m_profile(m_support.GetGame()->NewPureStrategyProfile()), 
     m_frozen1(pl), m_frozen2(0)
 {
+  Initialize();
   m_currentStrat[pl] = st;
-  m_profile->SetStrategy(m_support.GetStrategy(pl, st));
+  m_contingency.SetStrategy(m_strategies[pl][st]);
   First();
 }
 
 StrategyIterator::StrategyIterator(const StrategySupport &p_support,
 				   const GameStrategy &p_strategy)
   : m_atEnd(false), m_support(p_support),
+    m_strategies(p_support.GetGame()->NumPlayers()),
     m_currentStrat(p_support.GetGame()->NumPlayers()),
+    m_contingency(m_support),
     m_profile(p_support.GetGame()->NewPureStrategyProfile()), 
     m_frozen1(p_strategy->GetPlayer()->GetNumber()),
     m_frozen2(0)
 {
+  Initialize();
   m_currentStrat[m_frozen1] = p_strategy->GetNumber();
-  m_profile->SetStrategy(p_strategy);
+  m_contingency.SetStrategy(p_strategy);
   First();
 }
 
@@ -71,54 +93,63 @@ StrategyIterator::StrategyIterator(const StrategySupport &p_support,
 				   int pl1, int st1,
 				   int pl2, int st2)
   : m_atEnd(false), m_support(p_support), 
+    m_strategies(m_support.GetGame()->NumPlayers()),
     m_currentStrat(m_support.GetGame()->NumPlayers()),
+    m_contingency(m_support),
     m_profile(m_support.GetGame()->NewPureStrategyProfile()), 
     m_frozen1(pl1), m_frozen2(pl2)
 {
+  Initialize();
   m_currentStrat[pl1] = st1;
-  m_profile->SetStrategy(m_support.GetStrategy(pl1, st1));
+  m_contingency.SetStrategy(m_strategies[pl1][st1]);
   m_currentStrat[pl2] = st2;
-  m_profile->SetStrategy(m_support.GetStrategy(pl2, st2));
+  m_contingency.SetStrategy(m_strategies[pl2][st2]);
   First();
 }
 
+void StrategyIterator::Initialize(void)
+{
+  for (int pl = 1; pl <= m_strategies.Length(); pl++) {
+    m_strategies[pl] = Array<GameStrategyRep *>(m_support.NumStrategies(pl));
+    for (int st = 1; st <= m_strategies[pl].Length(); st++) {
+      m_strategies[pl][st] = m_support.GetStrategy(pl, st);
+    }
+  }
+}
+
 //---------------------------------------------------------------------------
 //                                Iteration
 //---------------------------------------------------------------------------
 
 void StrategyIterator::First(void)
 {
-  for (int pl = 1; pl <= m_support.GetGame()->NumPlayers(); pl++) {
+  for (int pl = 1; pl <= m_strategies.Length(); pl++) {
     if (pl == m_frozen1 || pl == m_frozen2) continue;
-    m_profile->SetStrategy(m_support.GetStrategy(pl, 1));
+    m_contingency.SetStrategy(m_strategies[pl][1]);
     m_currentStrat[pl] = 1;
   }	
 }
 
 void StrategyIterator::operator++(void)
 {
-  int pl = 1;
-
-  while (1)   {
-    if (pl == m_frozen1 || pl == m_frozen2) {
-      pl++;
-      if (pl > m_support.GetGame()->NumPlayers()) {
-	m_atEnd = true;
-	return;
-      }
-      continue;
-    }
+  for (int pl = 1; pl <= m_strategies.Length(); pl++) {
+    if (pl == m_frozen1 || pl == m_frozen2) continue;
 
-    if (m_currentStrat[pl] < m_support.NumStrategies(pl)) {
-      m_profile->SetStrategy(m_support.GetStrategy(pl, ++(m_currentStrat[pl])));
+    if (m_currentStrat[pl] < m_strategies[pl].Length()) {
+      m_contingency.SetStrategy(m_strategies[pl][++(m_currentStrat[pl])]);
       return;
     }
-    m_profile->SetStrategy(m_support.GetStrategy(pl, 1));
+    m_contingency.SetStrategy(m_strategies[pl][1]);
     m_currentStrat[pl] = 1;
-    pl++;
-    if (pl > m_support.GetGame()->NumPlayers()) {
-      m_atEnd = true;
-      return;
+  }
+  m_atEnd = true;
+}
+
+void StrategyIterator::UpdateProfile(void) const
+{
+  for (int pl = 1; pl <= m_strategies.Length(); pl++) {
+    if (m_profile->GetStrategy(pl) != m_contingency.GetStrategy(pl)) {
+      m_profile->SetStrategy(m_contingency.GetStrategy(pl));
     }
   }
 }
@@ -27,23 +27,80 @@
 
 namespace Gambit {
 
+/// \brief A pure strategy profile, held by value
+///
+/// A contingency records the strategy chosen by each player, together
+/// with the index of the profile in the table of outcomes of the game,
+/// which is one plus the sum of the offsets of the strategies chosen.
+/// Changing one player's strategy updates the index in constant time.
+/// Unlike PureStrategyProfile, the class is not polymorphic and holds no
+/// reference-counted handles, so stepping through contingencies involves
+/// no virtual calls, and copying a contingency makes one allocation.
+class StrategyContingency {
+private:
+  Array<GameStrategyRep *> m_strategies;
+  long m_index;
+
+public:
+  /// @name Lifecycle
+  //@{
+  /// Construct the contingency in which each player plays his first
+  /// strategy in the support
+  explicit StrategyContingency(const StrategySupport &);
+  //@}
+
+  /// @name Data access and manipulation
+  //@{
+  /// Get the strategy played by player pl
+  GameStrategyRep *GetStrategy(int pl) const { return m_strategies[pl]; }
+  /// Get the index of the profile in the table of outcomes
+  long GetIndex(void) const { return m_index; }
+  /// Get the index of the profile in which the player of the strategy
+  /// deviates to it, with all other players' strategies unchanged
+  long GetIndex(const GameStrategyRep *p_strategy) const
+  { 
+    return (m_index - m_strategies[p_strategy->m_player->GetNumber()]->m_offset +
+	    p_strategy->m_offset);
+  }
+  /// Set the strategy for the player of the strategy
+  void SetStrategy(GameStrategyRep *p_strategy)
+  {
+    GameStrategyRep *&current = m_strategies[p_strategy->m_player->GetNumber()];
+    m_index += p_strategy->m_offset - current->m_offset;
+    current = p_strategy;
+  }
+  //@}
+};
+
 /// This class iterates through the contingencies in a strategic game.
 /// It visits each strategy profile in turn, advancing one contingency
 /// on each call of NextContingency().  Optionally, the strategy of
 /// one player may be held fixed during the iteration (by the use of the
 /// second constructor).
+///
+/// The iterator steps a StrategyContingency, which loops that only need
+/// strategies and table indices can read through GetContingency().  The
+/// PureStrategyProfile returned by operator* is brought up to date with
+/// the contingency only when it is requested.
 class StrategyIterator {
   friend class GameRep;
   friend class GameTableRep;
 private:
   bool m_atEnd;
   StrategySupport m_support;
+  /// The strategies in the support of each player
+  Array<Array<GameStrategyRep *> > m_strategies;
   Array<int> m_currentStrat;
+  StrategyContingency m_contingency;
   PureStrategyProfile m_profile;
   int m_frozen1, m_frozen2;
   
+  /// Set up the strategies in the support (this is called by ctors)
+  void Initialize(void);
   /// Reset the iterator to the first contingency (this is called by ctors)
   void First(void);
+  /// Copy the current contingency into the profile
+  void UpdateProfile(void) const;
 
 public:
   /// @name Lifecycle
@@ -68,10 +125,15 @@ public:
   /// Has iterator gone past the end?
   bool AtEnd(void) const { return m_atEnd; }
 
+  /// Get the current contingency
+  const StrategyContingency &GetContingency(void) const 
+  { return m_contingency; }
   /// Get the current strategy profile
-  PureStrategyProfile &operator*(void) { return m_profile; }
+  PureStrategyProfile &operator*(void) 
+  { UpdateProfile(); return m_profile; }
   /// Get the current strategy profile
-  const PureStrategyProfile &operator*(void) const { return m_profile; }
+  const PureStrategyProfile &operator*(void) const 
+  { UpdateProfile(); return m_profile; }
   //@}
 };
 
@@ -21,6 +21,7 @@
 //
 
 #include "libgambit.h"
+#include "gametable.h"
 
 namespace Gambit {
 
@@ -225,6 +226,24 @@ bool StrategySupport::Dominates(const GameStrategy &s,
 				bool p_strict) const
 {
   bool equal = true;
+
+  if (!m_nfg->IsTree() && m_nfg->HasCompactPayoffs()) {
+    // Compare the two strategies in place in the dense payoff table
+    const Rational *payoffs =
+      dynamic_cast<GameTableRep &>(*m_nfg).GetPayoffTable<Rational>().GetPayoffs(s->GetPlayer()->GetNumber());
+    for (StrategyIterator iter(*this); !iter.AtEnd(); iter++) {
+      const Rational &ap = payoffs[iter.GetContingency().GetIndex(s) - 1];
+      const Rational &bp = payoffs[iter.GetContingency().GetIndex(t) - 1];
+      if (p_strict && ap <= bp) {
+	return false;
+      }
+      else if (!p_strict) {
+	if (ap < bp) return false;
+	else if (ap > bp) equal = false;
+      }
+    }
+    return (p_strict || !equal);
+  }
   
   for (StrategyIterator iter(*this); !iter.AtEnd(); iter++) {
     Rational ap = (*iter)->GetStrategyValue(s);
@@ -23,6 +23,7 @@
 #ifndef LUDECOMP_H
 #define LUDECOMP_H
 
+#include <vector>
 #include "libgambit/libgambit.h"
 #include "basis.h"
 
@@ -57,10 +58,12 @@ private:
   Tableau<T> &tab;
   Basis &basis;
 
-  Gambit::List< EtaMatrix<T> > L;
-  Gambit::List< EtaMatrix<T> > U;
-  Gambit::List< EtaMatrix<T> > E;
-  Gambit::List< int > P;
+  // The eta files are held in vectors, rather than lists, since they are
+  // traversed by index in each solve
+  std::vector< EtaMatrix<T> > L;
+  std::vector< EtaMatrix<T> > U;
+  std::vector< EtaMatrix<T> > E;
+  std::vector< int > P;
 
   Gambit::Vector<T> scratch1; // scratch vectors so we don't reallocate them
   Gambit::Vector<T> scratch2; // everytime we do something.
@@ -125,11 +125,41 @@ void Tableau<double>::SetConst(const Gambit::Vector<double> &bnew)
   Solve(*b, solution);
 }
 
-//** this function is not currently used.  Drop it?
+//
+// Brings the tableau to the basis 'in'.  The tableau is reset to the
+// slack basis, for which the LU factors are trivial, and the labels of
+// 'in' are pivoted in by eta updates, each into the row of largest
+// magnitude whose label is not in 'in'.  This keeps the eta file as
+// short as the number of structural variables in 'in'.  If no
+// acceptable pivot is found, the basis is set directly and refactored.
+//
 void Tableau<double>::SetBasis(const Basis &in)
 {
-  basis= in;
+  basis = Basis(basis.First(), basis.Last(), basis.MinCol(), basis.MaxCol());
   B.refactor();
+  for (int i = in.First(); i <= in.Last(); i++) {
+    int label = in.Label(i);
+    if (basis.Member(label)) continue;
+    SolveColumn(label, tmpcol);
+    int row = 0;
+    double best = eps2;
+    for (int k = MinRow(); k <= MaxRow(); k++) {
+      if (!in.Member(Label(k)) && fabs(tmpcol[k]) > best) {
+	row = k;
+	best = fabs(tmpcol[k]);
+      }
+    }
+    if (row == 0) {
+      basis = in;
+      B.refactor();
+      break;
+    }
+    basis.Pivot(row, label);
+    B.update(row, label);
+  }
+  for (int label = -basis.Last(); label <= basis.MaxCol(); label++) {
+    if (in.IsBlocked(label))  basis.Mark(label);
+  }
   Solve(*b, solution);
 }
 
@@ -482,13 +512,34 @@ void Tableau<Gambit::Rational>::SetConst(const Gambit::Vector<Gambit::Rational>
 }
 
 
-//** this function is not currently used.  Drop it?
+//
+// Brings the tableau to the basis 'in' by pivoting each of its labels
+// not in the current basis into a row whose label is not in 'in'.  Such
+// a row with a nonzero entry always exists, since 'in' is nonsingular.
+// The labels of 'in' may end up in different rows than in 'in' itself,
+// but the same labels are blocked.
+//
 void Tableau<Gambit::Rational>::SetBasis(const Basis &in)
 {
-  basis= in;
-  //** this has to be changed -- Need to start over and pivot to new basis.  
-  // B.refactor();
-  // B.solve(*b, solution);
+  for (int i = in.First(); i <= in.Last(); i++) {
+    int label = in.Label(i);
+    if (basis.Member(label)) continue;
+    MySolveColumn(label, tmpcol);
+    int row = 0;
+    for (int k = MinRow(); k <= MaxRow() && row == 0; k++) {
+      if (!in.Member(Label(k)) && tmpcol[k] != (Gambit::Rational) 0) {
+	row = k;
+      }
+    }
+    if (row == 0) throw BadPivot();
+    Pivot(row, label);
+  }
+  // The blocked labels are those of 'in', as for Tableau<double>, which
+  // starts afresh; marks left from the previous basis are cleared
+  for (int label = -basis.Last(); label <= basis.MaxCol(); label++) {
+    if (in.IsBlocked(label))  basis.Mark(label);
+    else  basis.UnMark(label);
+  }
 }
 
  // solve M x = b
@@ -0,0 +1,326 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/bench/rational.cc
+// Micro-benchmark of rational arithmetic on recorded pivot sequences
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <ctime>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <getopt.h>
+#include "libgambit/libgambit.h"
+
+using namespace Gambit;
+
+//
+// The benchmark records the sequence of pivots taken by Dantzig's
+// simplex method on the linear program max sum(x) s.t. A x <= 1, x >= 0,
+// where A is the (shifted, positive) payoff matrix of the first player
+// in a two-player strategic game; this is the program solved for
+// zero-sum games by gambit-lp.  The sequence is then replayed on fresh
+// tableaus, once using Rational, and once using fractions which are
+// reduced to lowest terms with a full gcd after every operation, as
+// Rational did before it had a word-sized fast path.
+//
+
+/// A fraction over Integer, reduced after every operation
+class ReducedFraction {
+private:
+  Integer m_num, m_den;
+
+  void Normalize(void)
+  {
+    if (sign(m_den) < 0) {
+      m_num.negate();
+      m_den.negate();
+    }
+    Integer g = gcd(m_num, m_den);
+    if (g != 1L) {
+      m_num /= g;
+      m_den /= g;
+    }
+  }
+
+public:
+  ReducedFraction(void) : m_num(0L), m_den(1L) { }
+  ReducedFraction(const Rational &p_value)
+    : m_num(p_value.numerator()), m_den(p_value.denominator()) { }
+
+  const Integer &GetNumerator(void) const { return m_num; }
+  const Integer &GetDenominator(void) const { return m_den; }
+
+  bool operator==(const ReducedFraction &y) const
+  { return m_num == y.m_num && m_den == y.m_den; }
+  bool operator!=(const ReducedFraction &y) const
+  { return !(*this == y); }
+
+  ReducedFraction operator*(const ReducedFraction &y) const
+  {
+    ReducedFraction r;
+    mul(m_num, y.m_num, r.m_num);
+    mul(m_den, y.m_den, r.m_den);
+    r.Normalize();
+    return r;
+  }
+  ReducedFraction operator/(const ReducedFraction &y) const
+  {
+    if (sign(y.m_num) == 0)  throw ZeroDivideException();
+    ReducedFraction r;
+    mul(m_num, y.m_den, r.m_num);
+    mul(m_den, y.m_num, r.m_den);
+    r.Normalize();
+    return r;
+  }
+  ReducedFraction operator-(const ReducedFraction &y) const
+  {
+    ReducedFraction r;
+    Integer tmp;
+    mul(m_num, y.m_den, r.m_num);
+    mul(m_den, y.m_num, tmp);
+    sub(r.m_num, tmp, r.m_num);
+    mul(m_den, y.m_den, r.m_den);
+    r.Normalize();
+    return r;
+  }
+};
+
+typedef std::vector<std::vector<Rational> > RationalTableau;
+
+/// A pivot, as a (row, column) pair of zero-based tableau indices
+typedef std::pair<int, int> Pivot;
+
+template <class T> 
+void DoPivot(std::vector<std::vector<T> > &p_tableau, int p_row, int p_col)
+{
+  std::vector<T> &pivotRow = p_tableau[p_row];
+  T pivot = pivotRow[p_col];
+  for (size_t j = 0; j < pivotRow.size(); j++) {
+    pivotRow[j] = pivotRow[j] / pivot;
+  }
+  for (size_t i = 0; i < p_tableau.size(); i++) {
+    if ((int) i == p_row)  continue;
+    T factor = p_tableau[i][p_col];
+    if (factor == T(Rational(0)))  continue;
+    std::vector<T> &row = p_tableau[i];
+    for (size_t j = 0; j < row.size(); j++) {
+      row[j] = row[j] - factor * pivotRow[j];
+    }
+  }
+}
+
+/// Builds the initial tableau; the last row is the objective
+RationalTableau BuildTableau(const Game &p_game)
+{
+  int m = p_game->GetPlayer(1)->NumStrategies();
+  int n = p_game->GetPlayer(2)->NumStrategies();
+  Rational shift = Rational(1) - p_game->GetMinPayoff();
+  RationalTableau tableau(m + 1, std::vector<Rational>(n + m + 1));
+
+  PureStrategyProfile profile = p_game->NewPureStrategyProfile();
+  for (int i = 0; i < m; i++) {
+    profile->SetStrategy(p_game->GetPlayer(1)->GetStrategy(i + 1));
+    for (int j = 0; j < n; j++) {
+      profile->SetStrategy(p_game->GetPlayer(2)->GetStrategy(j + 1));
+      tableau[i][j] = profile->GetPayoff(1) + shift;
+    }
+    tableau[i][n + i] = Rational(1);
+    tableau[i][n + m] = Rational(1);
+  }
+  for (int j = 0; j < n; j++) {
+    tableau[m][j] = Rational(-1);
+  }
+  return tableau;
+}
+
+/// Runs the simplex method on the tableau, recording the pivots taken
+std::vector<Pivot> RecordPivots(RationalTableau p_tableau)
+{
+  std::vector<Pivot> pivots;
+  int m = p_tableau.size() - 1, cols = p_tableau[0].size() - 1;
+  for (;;) {
+    int col = -1;
+    for (int j = 0; j < cols; j++) {
+      if (p_tableau[m][j] < Rational(0) && 
+	  (col < 0 || p_tableau[m][j] < p_tableau[m][col])) {
+	col = j;
+      }
+    }
+    if (col < 0)  return pivots;
+
+    int row = -1;
+    Rational best;
+    for (int i = 0; i < m; i++) {
+      if (p_tableau[i][col] > Rational(0)) {
+	Rational ratio = p_tableau[i][cols] / p_tableau[i][col];
+	if (row < 0 || ratio < best) {
+	  row = i;
+	  best = ratio;
+	}
+      }
+    }
+    if (row < 0)  return pivots;
+    DoPivot(p_tableau, row, col);
+    pivots.push_back(Pivot(row, col));
+  }
+}
+
+/// Replays the pivots on a copy of the tableau, returning the time taken
+template <class T>
+double Replay(const std::vector<std::vector<T> > &p_initial,
+	      const std::vector<Pivot> &p_pivots, int p_repeats,
+	      std::vector<std::vector<T> > &p_final)
+{
+  std::clock_t start = std::clock();
+  for (int rep = 0; rep < p_repeats; rep++) {
+    p_final = p_initial;
+    for (size_t k = 0; k < p_pivots.size(); k++) {
+      DoPivot(p_final, p_pivots[k].first, p_pivots[k].second);
+    }
+  }
+  return (double) (std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+void PrintBanner(std::ostream &p_stream)
+{
+  p_stream << "Benchmark rational arithmetic on recorded pivot sequences\n";
+  p_stream << "Gambit version " VERSION ", Copyright (C) 1994-2014, The Gambit Project\n";
+  p_stream << "This is free software, distributed under the GNU GPL\n\n";
+}
+
+void PrintHelp(char *progname)
+{
+  PrintBanner(std::cerr);
+  std::cerr << "Usage: " << progname << " [OPTIONS] [file]\n";
+  std::cerr << "If file is not specified, attempts to read game from standard input.\n";
+  std::cerr << "The game must be a two-player strategic game.\n\n";
+
+  std::cerr << "Options:\n";
+  std::cerr << "  -r REPEATS       replay each pivot sequence REPEATS times (default 10)\n";
+  std::cerr << "  -h, --help       print this help message\n";
+  std::cerr << "  -q               quiet mode (suppresses banner)\n";
+  std::cerr << "  -v, --version    print version information\n";
+  exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+  int c;
+  int repeats = 10;
+  bool quiet = false;
+
+  int long_opt_index = 0;
+  struct option long_options[] = {
+    { "help", 0, NULL, 'h'   },
+    { "version", 0, NULL, 'v'  },
+    { 0,    0,    0,    0   }
+  };
+  while ((c = getopt_long(argc, argv, "r:vqh", long_options, &long_opt_index)) != -1) {
+    switch (c) {
+    case 'v':
+      PrintBanner(std::cerr); exit(1);
+    case 'r':
+      repeats = atoi(optarg);
+      break;
+    case 'h':
+      PrintHelp(argv[0]);
+      break;
+    case 'q':
+      quiet = true;
+      break;
+    case '?':
+      if (isprint(optopt)) {
+	std::cerr << argv[0] << ": Unknown option `-" << ((char) optopt) << "'.\n";
+      }
+      else {
+	std::cerr << argv[0] << ": Unknown option character `\\x" << optopt << "`.\n";
+      }
+      return 1;
+    default:
+      abort();
+    }
+  }
+
+  if (!quiet) {
+    PrintBanner(std::cerr);
+  }
+
+  std::istream* input_stream = &std::cin;
+  std::ifstream file_stream;
+  if (optind < argc) {
+    file_stream.open(argv[optind]);
+    if (!file_stream.is_open()) {
+      std::ostringstream error_message;
+      error_message << argv[0] << ": " << argv[optind];
+      perror(error_message.str().c_str());
+      exit(1);
+    }
+    input_stream = &file_stream;
+  }
+
+  try {
+    Game game = ReadGame(*input_stream);
+    if (game->NumPlayers() != 2) {
+      std::cerr << "Error: game must have two players\n";
+      return 1;
+    }
+
+    RationalTableau initial = BuildTableau(game);
+    std::vector<Pivot> pivots = RecordPivots(initial);
+
+    std::vector<std::vector<ReducedFraction> > reducedInitial(initial.size());
+    for (size_t i = 0; i < initial.size(); i++) {
+      reducedInitial[i].assign(initial[i].begin(), initial[i].end());
+    }
+
+    RationalTableau rationalFinal;
+    std::vector<std::vector<ReducedFraction> > reducedFinal;
+    double rationalTime = Replay(initial, pivots, repeats, rationalFinal);
+    double reducedTime = Replay(reducedInitial, pivots, repeats, reducedFinal);
+
+    bool agree = true;
+    for (size_t i = 0; i < initial.size(); i++) {
+      for (size_t j = 0; j < initial[i].size(); j++) {
+	agree = agree && 
+	  (rationalFinal[i][j].numerator() == reducedFinal[i][j].GetNumerator() &&
+	   rationalFinal[i][j].denominator() == reducedFinal[i][j].GetDenominator());
+      }
+    }
+
+    std::cout << "pivots," << pivots.size() << std::endl;
+    std::cout << "repeats," << repeats << std::endl;
+    std::cout << "rational," << rationalTime << std::endl;
+    std::cout << "reduced," << reducedTime << std::endl;
+    std::cout << "agree," << ((agree) ? "yes" : "no") << std::endl;
+    return (agree) ? 0 : 1;
+  }
+  catch (InvalidFileException) {
+    std::cerr << "Error: Game not in a recognized format.\n";
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Error: An internal error occurred.\n";
+    return 1;
+  }
+}
@@ -21,28 +21,392 @@
 //
 
 #include <cstdlib>
+#include <climits>
 #include <getopt.h>
 #include <unistd.h>
 #include <iostream>
 #include <fstream>
 #include <cerrno>
+#include <algorithm>
+#include <vector>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif  // HAVE_PTHREAD_H
 #include "libgambit/libgambit.h"
+#include "libgambit/gametable.h"
 #include "libgambit/nash.h"
 
 using namespace Gambit;
 
 class NashEnumPureStrategySolver : public NashStrategySolver<Rational> {
 public:
-  NashEnumPureStrategySolver(shared_ptr<StrategyProfileRenderer<Rational> > p_onEquilibrium = 0) 
-    : NashStrategySolver<Rational>(p_onEquilibrium) { }
+  NashEnumPureStrategySolver(shared_ptr<StrategyProfileRenderer<Rational> > p_onEquilibrium = 0,
+			     int p_numThreads = 1, bool p_bestResponses = false) 
+    : NashStrategySolver<Rational>(p_onEquilibrium), 
+      m_numThreads(p_numThreads), m_bestResponses(p_bestResponses) { }
   virtual ~NashEnumPureStrategySolver()  { }
 
   List<MixedStrategyProfile<Rational> > Solve(const StrategySupport &p_support) const;
+
+private:
+  int m_numThreads;
+  bool m_bestResponses;
+
+  List<MixedStrategyProfile<Rational> > 
+  SolveBestResponses(const StrategySupport &p_support) const;
+#ifdef HAVE_PTHREAD_H
+  List<MixedStrategyProfile<Rational> > 
+  SolveParallel(const StrategySupport &p_support) const;
+#endif  // HAVE_PTHREAD_H
+  List<MixedStrategyProfile<Rational> > 
+  ReportEquilibria(const StrategySupport &p_support,
+		   const std::vector<long> &p_found) const;
 };
 
+//
+// Computes the offset in the dense payoff table of each player's
+// strategies in the game, and in the support.  The offset of a strategy
+// is its index less one, times the number of contingencies of the
+// players before it.
+//
+static void 
+ComputeOffsets(const StrategySupport &p_support,
+	       std::vector<std::vector<long> > &p_gameOffsets,
+	       std::vector<std::vector<long> > &p_supportOffsets)
+{
+  Game game = p_support.GetGame();
+  p_gameOffsets.assign(game->NumPlayers(), std::vector<long>());
+  p_supportOffsets.assign(game->NumPlayers(), std::vector<long>());
+  long stride = 1L;
+  for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+    GamePlayer player = game->GetPlayer(pl);
+    for (int st = 1; st <= player->NumStrategies(); st++) {
+      p_gameOffsets[pl - 1].push_back((st - 1) * stride);
+    }
+    for (int st = 1; st <= p_support.NumStrategies(pl); st++) {
+      p_supportOffsets[pl - 1].push_back((p_support.GetStrategy(pl, st)->GetNumber() - 1) * stride);
+    }
+    stride *= player->NumStrategies();
+  }
+}
+
+//
+// Renders and returns the equilibria, given as positions in the order in
+// which StrategyIterator visits the contingencies of the support
+//
+List<MixedStrategyProfile<Rational> >
+NashEnumPureStrategySolver::ReportEquilibria(const StrategySupport &p_support,
+					     const std::vector<long> &p_found) const
+{
+  Game game = p_support.GetGame();
+  List<MixedStrategyProfile<Rational> > solutions;
+  for (size_t i = 0; i < p_found.size(); i++) {
+    PureStrategyProfile profile = game->NewPureStrategyProfile();
+    long position = p_found[i];
+    for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+      int size = p_support.NumStrategies(pl);
+      profile->SetStrategy(p_support.GetStrategy(pl, position % size + 1));
+      position /= size;
+    }
+    MixedStrategyProfile<Rational> mixed = profile->ToMixedStrategyProfile();
+    m_onEquilibrium->Render(mixed);
+    solutions.Append(mixed);
+  }
+  return solutions;
+}
+
+//
+// The best-response table of a player marks each contingency of the
+// dense payoff table at which the player's strategy is a best response
+// to the strategies of the others.  It is computed in one pass over the
+// player's payoffs, blocks of which hold all the player's strategies
+// against consecutive contingencies of the other players.  The pure
+// equilibria are the contingencies marked in every player's table.
+//
+class BestResponseTable {
+public:
+  // The player's payoffs in the dense table, with the number of
+  // contingencies, and the player's number of strategies and stride
+  const Rational *m_payoffs;
+  long m_size, m_stride;
+  int m_dim;
+  std::vector<bool> m_best;
+#ifdef HAVE_PTHREAD_H
+  pthread_t m_thread;
+#endif  // HAVE_PTHREAD_H
+
+  void Compute(void);
+};
+
+void BestResponseTable::Compute(void)
+{
+  m_best.assign(m_size, false);
+  // For each contingency of the others in a block, the strategy with the
+  // largest payoff found so far
+  std::vector<int> top(m_stride);
+  for (long block = 0L; block < m_size; block += m_stride * m_dim) {
+    const Rational *payoffs = m_payoffs + block;
+    std::fill(top.begin(), top.end(), 0);
+    for (int st = 1; st < m_dim; st++) {
+      const Rational *row = payoffs + st * m_stride;
+      for (long i = 0L; i < m_stride; i++) {
+	if (row[i] > payoffs[top[i] * m_stride + i]) {
+	  top[i] = st;
+	}
+      }
+    }
+    for (int st = 0; st < m_dim; st++) {
+      const Rational *row = payoffs + st * m_stride;
+      for (long i = 0L; i < m_stride; i++) {
+	m_best[block + st * m_stride + i] = !(payoffs[top[i] * m_stride + i] > row[i]);
+      }
+    }
+  }
+}
+
+#ifdef HAVE_PTHREAD_H
+extern "C" void *RunBestResponseTable(void *p_table)
+{
+  static_cast<BestResponseTable *>(p_table)->Compute();
+  return 0;
+}
+#endif  // HAVE_PTHREAD_H
+
+List<MixedStrategyProfile<Rational> >
+NashEnumPureStrategySolver::SolveBestResponses(const StrategySupport &p_support) const
+{
+  Game game = p_support.GetGame();
+  const GameTableRep *table = dynamic_cast<const GameTableRep *>(game.operator->());
+  const PayoffTable<Rational> &payoffs = table->GetPayoffTable<Rational>();
+  const int numPlayers = game->NumPlayers();
+
+  std::vector<BestResponseTable> best(numPlayers);
+  long stride = 1L;
+  for (int pl = 0; pl < numPlayers; pl++) {
+    best[pl].m_payoffs = payoffs.GetPayoffs(pl + 1);
+    best[pl].m_size = payoffs.NumContingencies();
+    best[pl].m_stride = stride;
+    best[pl].m_dim = game->GetPlayer(pl + 1)->NumStrategies();
+    stride *= best[pl].m_dim;
+  }
+
+#ifdef HAVE_PTHREAD_H
+  // The players' tables are independent, and are computed in parallel,
+  // at most m_numThreads at a time; tables whose thread cannot be started
+  // are computed in this thread
+  const int numThreads = std::max(m_numThreads, 1);
+  for (int first = 0; first < numPlayers; first += numThreads) {
+    const int last = std::min(first + numThreads, numPlayers);
+    std::vector<bool> started(last - first, false);
+    for (int pl = first + 1; pl < last; pl++) {
+      started[pl - first] = (pthread_create(&best[pl].m_thread, 0,
+					    RunBestResponseTable, &best[pl]) == 0);
+    }
+    for (int pl = first; pl < last; pl++) {
+      if (!started[pl - first]) {
+	best[pl].Compute();
+      }
+    }
+    for (int pl = first + 1; pl < last; pl++) {
+      if (started[pl - first]) {
+	pthread_join(best[pl].m_thread, 0);
+      }
+    }
+  }
+#else
+  for (int pl = 0; pl < numPlayers; pl++) {
+    best[pl].Compute();
+  }
+#endif  // HAVE_PTHREAD_H
+
+  // AND the tables into the first, then visit the contingencies of the
+  // support in the order of StrategyIterator
+  std::vector<bool> &nash = best[0].m_best;
+  for (int pl = 1; pl < numPlayers; pl++) {
+    for (long i = 0L; i < (long) nash.size(); i++) {
+      nash[i] = nash[i] && best[pl].m_best[i];
+    }
+  }
+
+  std::vector<std::vector<long> > gameOffsets, offsets;
+  ComputeOffsets(p_support, gameOffsets, offsets);
+  std::vector<int> current(numPlayers, 0);
+  long index = 0L;
+  for (int pl = 0; pl < numPlayers; pl++) {
+    index += offsets[pl][0];
+  }
+  std::vector<long> found;
+  for (long position = 0L; ; position++) {
+    if (nash[index]) {
+      found.push_back(position);
+    }
+    int pl = 0;
+    for (; pl < numPlayers; pl++) {
+      index -= offsets[pl][current[pl]];
+      if (++current[pl] < (int) offsets[pl].size()) {
+	index += offsets[pl][current[pl]];
+	break;
+      }
+      current[pl] = 0;
+      index += offsets[pl][0];
+    }
+    if (pl == numPlayers) {
+      break;
+    }
+  }
+  return ReportEquilibria(p_support, found);
+}
+
+#ifdef HAVE_PTHREAD_H
+
+//
+// The contingencies of a strategic game with a dense payoff table are
+// enumerated in parallel by splitting the strategies of the first player
+// among the threads.  The threads only read the payoff table and the
+// offsets of the strategies in it, which are computed beforehand, and so
+// do not touch the reference counts of any game objects.
+//
+class EnumPureThread {
+public:
+  // The dense payoff table of the game
+  const PayoffTable<Rational> *m_payoffs;
+  // Offsets in the table of each player's strategies in the game, and
+  // of each player's strategies in the support
+  const std::vector<std::vector<long> > *m_gameOffsets, *m_supportOffsets;
+  // The first player's strategies enumerated by this thread, as
+  // positions in the support
+  int m_begin, m_end;
+  // Positions of the equilibria found, in the order of StrategyIterator
+  std::vector<long> m_found;
+  pthread_t m_thread;
+
+  bool IsNash(const std::vector<int> &p_current, long p_index) const;
+  void Run(void);
+};
+
+//
+// Returns true if no player has a strategy in the game that is a
+// profitable deviation from the contingency at p_index, whose strategies
+// are at the positions p_current in the support.
+//
+bool EnumPureThread::IsNash(const std::vector<int> &p_current, 
+			    long p_index) const
+{
+  for (size_t pl = 0; pl < p_current.size(); pl++) {
+    const Rational *payoffs = m_payoffs->GetPayoffs(pl + 1);
+    const Rational &current = payoffs[p_index];
+    const std::vector<long> &offsets = (*m_gameOffsets)[pl];
+    long others = p_index - (*m_supportOffsets)[pl][p_current[pl]];
+    for (size_t st = 0; st < offsets.size(); st++) {
+      if (payoffs[others + offsets[st]] > current) {
+	return false;
+      }
+    }
+  }
+  return true;
+}
+
+void EnumPureThread::Run(void)
+{
+  const std::vector<std::vector<long> > &offsets = *m_supportOffsets;
+  const int numPlayers = offsets.size();
+  const long firstSize = offsets[0].size();
+  std::vector<int> current(numPlayers);
+
+  for (int first = m_begin; first < m_end; first++) {
+    std::fill(current.begin(), current.end(), 0);
+    current[0] = first;
+    long index = 0L;
+    for (int pl = 0; pl < numPlayers; pl++) {
+      index += offsets[pl][current[pl]];
+    }
+
+    // Players other than the first are advanced as by StrategyIterator,
+    // and 'rest' counts the contingencies of those players
+    for (long rest = 0L; ; rest++) {
+      if (IsNash(current, index)) {
+	m_found.push_back(first + firstSize * rest);
+      }
+      int pl = 1;
+      for (; pl < numPlayers; pl++) {
+	index -= offsets[pl][current[pl]];
+	if (++current[pl] < (int) offsets[pl].size()) {
+	  index += offsets[pl][current[pl]];
+	  break;
+	}
+	current[pl] = 0;
+	index += offsets[pl][0];
+      }
+      if (pl == numPlayers) {
+	break;
+      }
+    }
+  }
+}
+
+extern "C" void *RunEnumPureThread(void *p_thread)
+{
+  static_cast<EnumPureThread *>(p_thread)->Run();
+  return 0;
+}
+
+List<MixedStrategyProfile<Rational> >
+NashEnumPureStrategySolver::SolveParallel(const StrategySupport &p_support) const
+{
+  Game game = p_support.GetGame();
+  const GameTableRep *table = dynamic_cast<const GameTableRep *>(game.operator->());
+  std::vector<std::vector<long> > gameOffsets, supportOffsets;
+  ComputeOffsets(p_support, gameOffsets, supportOffsets);
+
+  const int firstSize = p_support.NumStrategies(1);
+  const int numThreads = std::min(m_numThreads, firstSize);
+  std::vector<EnumPureThread> threads(numThreads);
+  for (int i = 0; i < numThreads; i++) {
+    threads[i].m_payoffs = &table->GetPayoffTable<Rational>();
+    threads[i].m_gameOffsets = &gameOffsets;
+    threads[i].m_supportOffsets = &supportOffsets;
+    threads[i].m_begin = firstSize * i / numThreads;
+    threads[i].m_end = firstSize * (i + 1) / numThreads;
+  }
+  // Threads which cannot be started are run in this thread instead
+  std::vector<bool> started(numThreads, false);
+  for (int i = 1; i < numThreads; i++) {
+    started[i] = (pthread_create(&threads[i].m_thread, 0,
+				 RunEnumPureThread, &threads[i]) == 0);
+  }
+  for (int i = 0; i < numThreads; i++) {
+    if (!started[i]) {
+      threads[i].Run();
+    }
+  }
+  std::vector<long> found;
+  for (int i = 0; i < numThreads; i++) {
+    if (started[i]) {
+      pthread_join(threads[i].m_thread, 0);
+    }
+    found.insert(found.end(), threads[i].m_found.begin(), threads[i].m_found.end());
+  }
+  std::sort(found.begin(), found.end());
+  return ReportEquilibria(p_support, found);
+}
+
+#endif  // HAVE_PTHREAD_H
+
 List<MixedStrategyProfile<Rational> >
 NashEnumPureStrategySolver::Solve(const StrategySupport &p_support) const
 {
+  if (!p_support.GetGame()->IsTree() && 
+      p_support.GetGame()->HasCompactPayoffs()) {
+    if (m_bestResponses) {
+      return SolveBestResponses(p_support);
+    }
+#ifdef HAVE_PTHREAD_H
+    if (m_numThreads > 1) {
+      return SolveParallel(p_support);
+    }
+#endif  // HAVE_PTHREAD_H
+  }
+
   List<MixedStrategyProfile<Rational> > solutions;
   for (StrategyIterator citer(p_support); !citer.AtEnd(); citer++) {
     if ((*citer)->IsNash()) {
@@ -97,6 +461,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -S               report equilibria in strategies even for extensive games\n";
   std::cerr << "  -A               compute agent form equilibria\n";
   std::cerr << "  -P               find only subgame-perfect equilibria\n";
+  std::cerr << "  -j THREADS       number of threads for strategic games (default 1)\n";
+  std::cerr << "  -b               use best-response tables for strategic games\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -v, --version    print version information\n";
@@ -109,6 +475,8 @@ int main(int argc, char *argv[])
   opterr = 0;
   bool quiet = false, reportStrategic = false, solveAgent = false, bySubgames = false;
   bool printDetail = false;
+  int numThreads = 1;
+  bool useBestResponses = false;
   
   int long_opt_index = 0;
   struct option long_options[] = {
@@ -117,7 +485,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "DvhqASP", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "DvhqASPj:b", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -133,6 +501,19 @@ int main(int argc, char *argv[])
     case 'P':
       bySubgames = true;
       break;
+    case 'j': {
+      char *end;
+      long threads = strtol(optarg, &end, 10);
+      if (end == optarg || *end != '\0' || threads < 1 || threads > INT_MAX) {
+	std::cerr << argv[0] << ": Number of threads must be a positive integer.\n";
+	PrintHelp(argv[0]);
+      }
+      numThreads = (int) threads;
+      break;
+    }
+    case 'b':
+      useBestResponses = true;
+      break;
     case 'h':
       PrintHelp(argv[0]);
       break;
@@ -171,6 +552,7 @@ int main(int argc, char *argv[])
 
   try {
     Game game = ReadGame(*input_stream);
+    game->SetCompactPayoffs(true);
     shared_ptr<StrategyProfileRenderer<Rational> > renderer;
     if (reportStrategic || !game->IsTree()) {
       if (printDetail) {
@@ -215,7 +597,8 @@ int main(int argc, char *argv[])
       }
     }
     else {
-      NashEnumPureStrategySolver algorithm(renderer);
+      NashEnumPureStrategySolver algorithm(renderer, numThreads,
+					     useBestResponses);
       algorithm.Solve(game);
     }
     return 0;
@@ -28,7 +28,6 @@ cvector::~cvector() { delete []x; }
 cmatrix::~cmatrix()
  { delete []x; }
 
-int cvector::num_vec_cons = 0;
 cmatrix cmatrix::inv(bool &worked) const {
 	if (m!=n) {
 		cerr << "invalid cmatrix inverse" << endl;
@@ -513,3 +512,166 @@ double cmatrix::trace() {
   return sum;
 }
 	
+
+clufactor::clufactor(int n) : n(n), numUpdates(0), d(0.0), lu(n,n), ix(n),
+			      work(n), coef(n), hy(n) { }
+
+bool clufactor::factor(const cmatrix &m) {
+	int i, j, k, c, j0, jb, p;
+	double big, dum, l;
+	double *x = lu.values();
+	const double *y = m[0];
+	for(i = 0; i < n*n; i++) x[i] = y[i];
+	numUpdates = 0;
+	a.clear();
+	b.clear();
+	d = 1.0;
+
+	for(j0 = 0; j0 < n; j0 += BLOCK) {
+		jb = (n-j0 < BLOCK) ? n-j0 : BLOCK;
+		// eliminate within the panel of columns j0..j0+jb-1,
+		// swapping whole rows
+		for(j = j0; j < j0+jb; j++) {
+			big = 0.0;
+			p = j;
+			for(i = j; i < n; i++) {
+				if ((dum = fabs(x[i*n+j])) > big) {
+					big = dum;
+					p = i;
+				}
+			}
+			if (big == 0.0) {
+				d = 0.0;
+				return false;
+			}
+			ix[j] = p;
+			if (p != j) {
+				for(c = 0; c < n; c++) {
+					dum = x[p*n+c];
+					x[p*n+c] = x[j*n+c];
+					x[j*n+c] = dum;
+				}
+				d = -d;
+			}
+			d *= x[j*n+j];
+			dum = 1.0/x[j*n+j];
+			for(i = j+1; i < n; i++) {
+				l = (x[i*n+j] *= dum);
+				for(c = j+1; c < j0+jb; c++)
+					x[i*n+c] -= l*x[j*n+c];
+			}
+		}
+		// the block row of U to the right of the panel
+		for(j = j0; j < j0+jb; j++)
+			for(i = j+1; i < j0+jb; i++) {
+				l = x[i*n+j];
+				for(c = j0+jb; c < n; c++)
+					x[i*n+c] -= l*x[j*n+c];
+			}
+		// the trailing submatrix, by a rank-jb update
+		for(i = j0+jb; i < n; i++)
+			for(k = j0; k < j0+jb; k++) {
+				l = x[i*n+k];
+				if (l != 0.0)
+					for(c = j0+jb; c < n; c++)
+						x[i*n+c] -= l*x[k*n+c];
+			}
+	}
+	return true;
+}
+
+void clufactor::lusolve(double *v) const {
+	int i, j;
+	double sum, dum;
+	const double *x = lu[0];
+	for(i = 0; i < n; i++) {
+		if (ix[i] != i) {
+			dum = v[i];
+			v[i] = v[ix[i]];
+			v[ix[i]] = dum;
+		}
+	}
+	for(i = 1; i < n; i++) {
+		sum = v[i];
+		for(j = 0; j < i; j++) sum -= x[i*n+j]*v[j];
+		v[i] = sum;
+	}
+	for(i = n-1; i >= 0; i--) {
+		sum = v[i];
+		for(j = i+1; j < n; j++) sum -= x[i*n+j]*v[j];
+		v[i] = sum/x[i*n+i];
+	}
+}
+
+// solves with the transpose of the factored matrix; the columns of the
+// factors are traversed as rows, eliminating forward along each
+void clufactor::lusolvetrans(double *v) const {
+	int i, j;
+	double dum;
+	const double *x = lu[0];
+	for(i = 0; i < n; i++) {
+		v[i] /= x[i*n+i];
+		dum = v[i];
+		for(j = i+1; j < n; j++) v[j] -= x[i*n+j]*dum;
+	}
+	for(i = n-1; i > 0; i--) {
+		dum = v[i];
+		for(j = 0; j < i; j++) v[j] -= x[i*n+j]*dum;
+	}
+	for(i = n-1; i >= 0; i--) {
+		if (ix[i] != i) {
+			dum = v[i];
+			v[i] = v[ix[i]];
+			v[ix[i]] = dum;
+		}
+	}
+}
+
+void clufactor::solve(const cvector &v, cvector &dest) const {
+	int i, k;
+	double sum;
+	for(k = 0; k < numUpdates; k++) {
+		sum = 0.0;
+		for(i = 0; i < n; i++) sum += b[k*n+i]*v[i];
+		coef[k] = sum;
+	}
+	for(i = 0; i < n; i++) dest[i] = v[i];
+	lusolve(dest.values());
+	for(k = 0; k < numUpdates; k++)
+		for(i = 0; i < n; i++) dest[i] += a[k*n+i]*coef[k];
+}
+
+// The inverse update is H' = H + (s - Hy)(H^T s)^T / (s^T H y), and the
+// determinant is scaled by s^T H y / s^T s
+bool clufactor::update(const cvector &s, const cvector &y) {
+	int i, k;
+	double sHy = 0.0, ss = 0.0, norm = 0.0, sum;
+	solve(y, hy);
+	for(i = 0; i < n; i++) {
+		sHy += s[i]*hy[i];
+		ss += s[i]*s[i];
+		norm += hy[i]*hy[i];
+	}
+	if (ss == 0.0 || fabs(sHy) <= 1.0e-10*sqrt(ss*norm))
+		return false;
+
+	// H^T s, from the factors and the earlier updates
+	for(i = 0; i < n; i++) work[i] = s[i];
+	lusolvetrans(&work[0]);
+	for(k = 0; k < numUpdates; k++) {
+		sum = 0.0;
+		for(i = 0; i < n; i++) sum += a[k*n+i]*s[i];
+		for(i = 0; i < n; i++) work[i] += b[k*n+i]*sum;
+	}
+
+	a.resize((numUpdates+1)*n);
+	b.resize((numUpdates+1)*n);
+	coef.resize(numUpdates+1);
+	for(i = 0; i < n; i++) {
+		a[numUpdates*n+i] = (s[i]-hy[i])/sHy;
+		b[numUpdates*n+i] = work[i];
+	}
+	numUpdates++;
+	d *= sHy/ss;
+	return true;
+}
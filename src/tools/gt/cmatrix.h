@@ -45,33 +45,27 @@ public:
 class cvector {
 friend class cmatrix;
 public:
- static int num_vec_cons; 
 	inline cvector() {
-	  cvector::num_vec_cons++;
 		m = 1;
 		x = new double[1];
 	}
 	inline cvector(int m) {
-	  cvector::num_vec_cons++;
 		this->m = m;
 		x = new double[m];
 	}
 	~cvector(); 
 	inline cvector(const cvector &v) {
-	  cvector::num_vec_cons++;
 		m = v.m;
 		x = new double[m];
 		//for(int i=0;i<m;i++) x[i] = v.x[i];
 		memcpy(x,v.x,m*sizeof(double));
 	}
 	inline cvector(int m, const double &a) {
-	  cvector::num_vec_cons++;
 		this->m = m;
 		x = new double[m];
 		for(int i=0;i<m;i++) x[i] = a;
 	}
 	inline cvector(double *v, int m, bool keep=false) {
-	  cvector::num_vec_cons++;
 		this->m = m;
 		if (keep) x = v;
 		else {
@@ -888,4 +882,47 @@ inline istream& operator>>(istream& s, cmatrix& ma) {
 	for(int i=0;i<ma.s;i++) { s >> ma.x[i]; }
 	return s;
 }
+
+// An LU factorization of a square matrix, with partial pivoting, which
+// can be corrected by Broyden's rank-one updates between
+// refactorizations.  The factors are computed by a blocked elimination
+// whose inner loops run along the contiguous rows.  The updates are held
+// as pairs of vectors, applied after the triangular solves, so each costs
+// O(n^2) to make and adds O(n) to a solve.
+class clufactor {
+public:
+	clufactor(int n);
+
+	// factors a, discarding any updates; returns false, leaving no
+	// usable factorization, if a is singular
+	bool factor(const cmatrix &a);
+
+	// applies Broyden's update for a step s whose image under the
+	// matrix is y, so that the factored matrix maps s to y; returns
+	// false, leaving it unchanged, if the update is nearly singular
+	bool update(const cvector &s, const cvector &y);
+
+	// dest = A^-1 b, where A is the factored matrix with its updates
+	void solve(const cvector &b, cvector &dest) const;
+
+	inline double det() const { return d; }
+	inline int getNumUpdates() const { return numUpdates; }
+
+private:
+	enum { BLOCK = 32 };
+
+	// in place solves with the factors, without the updates
+	void lusolve(double *b) const;
+	void lusolvetrans(double *b) const;
+
+	int n, numUpdates;
+	double d;
+	cmatrix lu;
+	std::vector<int> ix;
+	// the inverse is lu^-1 + sum of a_i b_i^T, the pairs stored
+	// one after another
+	std::vector<double> a, b;
+	mutable std::vector<double> work, coef;
+	cvector hy;
+};
 #endif
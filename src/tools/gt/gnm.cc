@@ -38,8 +38,51 @@ void PrintProfile(std::ostream &p_stream,
   p_stream << std::endl;
 }
 
-// gnm(A,g,Eq,steps,fuzz,LNMFreq,LNMMax,LambdaMin,wobble,threshold)
-// ----------------------------------------------------------------
+// The jacobian of the vector field is I-((I+DG)*R); this sets
+// dest to its product with x, in O(M^2), without forming it.
+static void jacobianMultiply(cmatrix &DG, cmatrix &R, const cvector &x,
+			     cvector &dest, cvector &scratch) {
+  R.multiply(x, scratch);
+  DG.multiply(scratch, dest);
+  dest += scratch;
+  dest.negate();
+  dest += x;
+}
+
+// Solves J x = b, J the jacobian above, by iterative refinement from
+// the solution with H, the factorization of a nearby jacobian
+class jacobiansolver : public gnmsolver {
+public:
+  jacobiansolver(const clufactor &H, cmatrix &DG, cmatrix &R, int M)
+    : H(H), DG(DG), R(R), r(M), scratch1(M), scratch2(M) { }
+
+  // returns false if the residual is not small after a few iterations
+  bool refine(const cvector &b, cvector &x) {
+    const int maxIterations = 4;
+    const double tolerance = 1e-10 * max(b.max(), -b.min());
+    H.solve(b, x);
+    for(int iter = 0; iter < maxIterations; iter++) {
+      jacobianMultiply(DG, R, x, r, scratch1);
+      r -= b;
+      if(max(r.max(), -r.min()) <= tolerance) {
+	return true;
+      }
+      H.solve(r, scratch2);
+      x -= scratch2;
+    }
+    return false;
+  }
+
+  void solve(const cvector &b, cvector &x) { refine(b, x); }
+
+private:
+  const clufactor &H;
+  cmatrix &DG, &R;
+  cvector r, scratch1, scratch2;
+};
+
+// gnm(A,g,Eq,steps,fuzz,LNMFreq,LNMMax,LambdaMin,wobble,threshold,LUFreq,stats,out)
+// --------------------------------------------------------------------
 // This executes the GNM algorithm on game A.
 // Interpretation of parameters:
 // g: perturbation ray.
@@ -63,8 +106,17 @@ void PrintProfile(std::ostream &p_stream,
 // threshold: the equilibrium error threshold for doing a wobble.  If
 //            wobbles are disabled, GNM will terminate if the error
 //            reaches this threshold.
-
-int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold) {
+// LUFreq: if zero, the adjoint of the Jacobian is computed exactly at
+//         each step.  Otherwise, the Jacobian is LU factored every
+//         LUFreq steps, and at each change of support, and the
+//         factorization is corrected by Broyden updates in between,
+//         each O(M^2) rather than O(M^3).  Solves with an updated
+//         factorization are refined against the exact Jacobian.
+// stats: the numbers of factorizations, updates and adjoints made.
+// out: the stream to which equilibria, and in verbose mode the
+//      points along the path, are printed.
+
+int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold, int LUFreq, gnmstats &stats, Gambit::MultiStartOutput &out) {
   int i, // utility variables
     bestAction,  
     k, 
@@ -75,12 +127,14 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
     s_hat, // the next pure strategy to enter or leave the support
     Index = 1, // index of the equilibrium we're moving towards
     numEq = 0, // number of equilibria found so far
-    stepsLeft; // number of linear steps remaining until we hit the boundary
+    stepsLeft, // number of linear steps remaining until we hit the boundary
+    sinceFactor = 0; // number of steps since H was factored
+  bool factored = false; // whether H holds the Jacobian of the current step
 
   int N = A.getNumPlayers(), 
     M = A.getNumActions(); // the two most important cvector sizes, stored locally for brevity
   double bestPayoff, 
-    det, // determinant of the jacobian
+    det = 1.0, // determinant of the jacobian
     newV, // utility variable
     lambda, // current position along the ray
     dlambda, // derivative of lambda w.r.t time
@@ -111,15 +165,23 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
     dv(M), // derivative of v w.r.t. time
     nothing(M,0),// cvector of all zeros
     err(M),
-    backup(M); 
+    backup(M),
+    ds(M), // direction of the last step, along which H is updated
+    dy(M); // image of ds under the current Jacobian
 
+  clufactor H(M); // factorization of the jacobian, used if LUFreq > 0
 
   // utility variables for use as intermediate values in computations
   cmatrix Y1(M,M), Y2(M,M), Y3(M,M);
   cvector G(N), yn1(N), ym1(M), ym2(M), ym3(M);
 
+  // solvers with H in the jacobian of the step, and in that at the start
+  // of LNM, copied to Y1 as LNM changes DG as it goes
+  jacobiansolver pathSolver(H, DG, R, M), newtonSolver(H, Y1, R, M);
+
   // INITIALIZATION
   Eq = (cvector **)malloc(sizeof(cvector *));
+  stats.factorizations = stats.updates = stats.adjoints = 0;
 
   // Find the lone equilibrium of the perturbed game
   for(n = 0; n < N; n++) {
@@ -143,7 +205,7 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
   }
 
   if (g_verbose) {
-    PrintProfile(std::cout, "start", sigma);
+    PrintProfile(out.GetStream(), "start", sigma);
   }
 
   A.payoffMatrix(DG, sigma, fuzz);
@@ -211,19 +273,52 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 
     // take the specified number of steps within these support boundaries.  
     for(stepsLeft = steps; stepsLeft > 0; stepsLeft--) { 
-      //find J = Adj psi
-      J = I;
-      J += DG;
-      J *= R;
-      J -= I;
-      J.negate();
-      // J = I-((I+DG)*R);
-      det = J.adjoint(); // sets J = adjoint(J)
-
-      // find derivatives of z and lambda
-      J.multiply(g,dz);
-      dz.negate();      
-       //dz = -(J*g);
+      // between factorizations, update H along the last step, and
+      // use it to solve for dz with the current jacobian.  The path
+      // must keep its orientation, which is taken from the sign of the
+      // determinant; if that or the solve fails, refactor.
+      if(factored && sinceFactor < LUFreq) {
+	jacobianMultiply(DG, R, ds, dy, ym1);
+	factored = (H.update(ds, dy) &&
+		    pathSolver.refine(g, dz));
+	if(factored) {
+	  dz *= -H.det();
+	  factored = (dz * ds + H.det() * det > 0.0);
+	}
+	if(factored) {
+	  det = H.det();
+	  sinceFactor++;
+	  stats.updates++;
+	}
+      } else {
+	factored = false;
+      }
+
+      if(!factored) {
+	//find J = Adj psi
+	J = I;
+	J += DG;
+	J *= R;
+	J -= I;
+	J.negate();
+	// J = I-((I+DG)*R);
+	factored = (LUFreq > 0 && H.factor(J));
+	// find derivatives of z and lambda
+	if(factored) {
+	  sinceFactor = 1;
+	  stats.factorizations++;
+	  det = H.det();
+	  H.solve(g,dz);
+	  dz *= -det;
+	} else {
+	  det = J.adjoint(); // sets J = adjoint(J)
+	  stats.adjoints++;
+	  J.multiply(g,dz);
+	  dz.negate();      
+	}
+	//dz = -(J*g);
+      }
+      ds = dz;
       dlambda = -det;
       R.multiply(dz, ym1);
       DG.multiply(ym1,dv);
@@ -304,8 +399,18 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 	    J -= I; 
 	    J.negate();
 	    //J=I-((I+DG)*R);
-	    det = J.adjoint();
-	    ee = A.LNM(z, nothing, det, J, DG, sigma, LNMMax, fuzz,ym1,ym2,ym3);
+	    factored = (LUFreq > 0 && H.factor(J));
+	    if(factored) {
+	      sinceFactor = 1;
+	      stats.factorizations++;
+	      det = H.det();
+	      Y1 = DG;
+	      ee = A.LNM(z, nothing, det, newtonSolver, DG, sigma, LNMMax, fuzz,ym1,ym2,ym3);
+	    } else {
+	      det = J.adjoint();
+	      stats.adjoints++;
+	      ee = A.LNM(z, nothing, det, J, DG, sigma, LNMMax, fuzz,ym1,ym2,ym3);
+	    }
 	  }
 	  for (int idx=0;idx<M;idx++)
 	    if (! isfinite(sigma[idx])){
@@ -318,7 +423,11 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 	    Eq[numEq] = new cvector(M);
 	    *(Eq[numEq++]) = sigma;
 
-	    PrintProfile(std::cout, "NE", sigma);
+	    std::ostringstream text;
+	    PrintProfile(text, "NE", sigma);
+	    out.AddEquilibrium(std::vector<double>(sigma.values(),
+						   sigma.values() + M),
+			       text.str());
       }
 	  Index = -Index;
 	  s_hat_old = -1;
@@ -382,7 +491,12 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 
       // if we've done LNMMax repetitions, time to get back on the path
       if(stepsLeft > 1 && (++k == LNMFreq)) {
-	A.LNM(z, g0, det, J, DG, sigma, LNMMax, fuzz,ym1,ym2,ym3);
+	if(factored) {
+	  Y1 = DG;
+	  A.LNM(z, g0, det, newtonSolver, DG, sigma, LNMMax, fuzz,ym1,ym2,ym3);
+	} else {
+	  A.LNM(z, g0, det, J, DG, sigma, LNMMax, fuzz,ym1,ym2,ym3);
+	}
 	k = 0;
       }
     } // end of for loop
@@ -399,6 +513,7 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 	}
     B[s_hat] = !B[s_hat];
     A.retractJac(R,B);
+    factored = false; // R has changed, so refactor
     s_hat_old = s_hat;
     A.retract(ym1, z);
     sigma = ym1;
@@ -407,7 +522,7 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
     A.normalizeStrategy(sigma);
 
     if (g_verbose) {
-      PrintProfile(std::cout, Gambit::lexical_cast<std::string>(lambda), sigma);
+      PrintProfile(out.GetStream(), Gambit::lexical_cast<std::string>(lambda), sigma);
     }
 
     z -= ym1;
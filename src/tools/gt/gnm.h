@@ -20,9 +20,17 @@
 #ifndef __GNM_H
 #define __GNM_H
 
+#include "libgambit/multistart.h"
 #include "cmatrix.h"
 #include "gnmgame.h"
 
-int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold);
+// counts of the ways GNM obtained the inverse of the path Jacobian
+struct gnmstats {
+  int factorizations, // LU factorizations
+    updates, // Broyden updates of a factorization
+    adjoints; // adjoints computed exactly
+};
+
+int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold, int LUFreq, gnmstats &stats, Gambit::MultiStartOutput &out);
 
 #endif
@@ -192,10 +192,19 @@ void gnmgame::KSymNormalizeStrategy(cvector& s){
 }
 
 double gnmgame::LNM(cvector &z, const cvector &g, double det, cmatrix &J, cmatrix &DG, cvector &s, int MaxLNM, double fuzz, cvector &del, cvector &scratch, cvector &backup, bool ksym) {
+  return runLNM(z, g, det, &J, 0, DG, s, MaxLNM, fuzz, del, scratch, backup, ksym);
+}
+
+double gnmgame::LNM(cvector &z, const cvector &g, double det, gnmsolver &H, cmatrix &DG, cvector &s, int MaxLNM, double fuzz, cvector &del, cvector &scratch, cvector &backup, bool ksym) {
+  return runLNM(z, g, det, 0, &H, DG, s, MaxLNM, fuzz, del, scratch, backup, ksym);
+}
+
+// The Newton step is J^-1 del; with the adjoint this is J del / det
+double gnmgame::runLNM(cvector &z, const cvector &g, double det, cmatrix *J, gnmsolver *H, cmatrix &DG, cvector &s, int MaxLNM, double fuzz, cvector &del, cvector &scratch, cvector &backup, bool ksym) {
   double b, e = BIGFLOAT, ee;
   int k, faulted = 0;
   if(MaxLNM >= 1 && det != 0.0) {
-    b = 1.0/det;
+    b = (H) ? 1.0 : 1.0/det;
     for(k = 0; k < MaxLNM; k++) {
       //      del = z - s - DG*s / (double)(numPlayers - 1) - g; 
       DG.multiply(s,del);
@@ -221,7 +230,11 @@ double gnmgame::LNM(cvector &z, const cvector &g, double det, cmatrix &J, cmatri
 	continue;
       }
       e = ee;
-      J.multiply(del, scratch);
+      if(H) {
+	H->solve(del, scratch);
+      } else {
+	J->multiply(del, scratch);
+      }
       scratch *= b;
       backup = z;
       z -= scratch;
@@ -30,6 +30,15 @@
 #endif
 #endif
 
+// Solves linear systems in the Jacobian of the path, for LNM, when the
+// adjoint is not formed
+class gnmsolver {
+ public:
+  virtual ~gnmsolver() { }
+  // sets x = J^-1 b
+  virtual void solve(const cvector &b, cvector &x) = 0;
+};
+
 class gnmgame {
  public:
   
@@ -159,6 +168,10 @@ class gnmgame {
 
   double LNM(cvector &z, const cvector &g, double det, cmatrix &J, cmatrix &DG,  cvector &s, int MaxLNM, double fuzz, cvector &del, cvector &scratch, cvector &backup, bool ksym=false);
 
+  // As above, with systems in the Jacobian solved by H rather than
+  // through the adjoint J.
+  double LNM(cvector &z, const cvector &g, double det, gnmsolver &H, cmatrix &DG,  cvector &s, int MaxLNM, double fuzz, cvector &del, cvector &scratch, cvector &backup, bool ksym=false);
+
   // This normalizes a strategy profile by scaling appropriately.
   void normalizeStrategy(cvector &s);
 
@@ -237,6 +250,8 @@ class gnmgame {
 
  protected:
   
+  double runLNM(cvector &z, const cvector &g, double det, cmatrix *J, gnmsolver *H, cmatrix &DG,  cvector &s, int MaxLNM, double fuzz, cvector &del, cvector &scratch, cvector &backup, bool ksym);
+
   int Pivot(cmatrix &T, int pr, int pc, std::vector<int> &row, std::vector<int> &col, 
 	    double &D);
 
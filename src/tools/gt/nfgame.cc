@@ -17,22 +17,121 @@
  * Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <cstring>
 #include <vector>
 #include "cmatrix.h"
 #include "nfgame.h"
+#include "libgambit/gametable.h"
+#include "libgambit/payofftable.h"
 
-nfgame::nfgame(int numPlayers, int *actions, const cvector &payoffs) : gnmgame(numPlayers, actions), payoffs(payoffs) {
+nfgame::nfgame(int numPlayers, int *actions, const cvector &payoffs)
+  : gnmgame(numPlayers, actions), storage(new cvector(payoffs)) {
+  this->payoffs = storage->values();
+  initialize();
+}
+
+nfgame::nfgame(const Gambit::Game &game, bool normalize)
+  : gnmgame(game->NumPlayers(), &game->NumStrategies()[1]) {
+  initialize();
+
+  // The rescaling is done exactly on the game's payoffs, and only the
+  // results are rounded, as gnm has always done
+  Gambit::Rational minPay(0);
+  double scale = 1.0;
+  if (normalize) {
+    minPay = game->GetMinPayoff();
+    Gambit::Rational maxPay = game->GetMaxPayoff();
+    if (maxPay > minPay) {
+      scale = 1.0 / (maxPay - minPay);
+    }
+  }
+
+  const Gambit::GameTableRep *table =
+    dynamic_cast<const Gambit::GameTableRep *>(&*game);
+  if (table && !normalize) {
+    this->game = game;
+    payoffs = table->GetPayoffTable<double>().GetPayoffs(1);
+    return;
+  }
+
+  storage.reset(new cvector(numPlayers * numStrategies));
+  payoffs = storage->values();
+  if (table) {
+    // Both tables are player-major, with the first player's strategy
+    // varying fastest, so entry i of one is entry i of the other
+    const Gambit::Rational *src =
+      table->GetPayoffTable<Gambit::Rational>().GetPayoffs(1);
+    double *dest = storage->values();
+    int size = numPlayers * numStrategies;
+    for(int i = 0; i < size; i++) {
+      dest[i] = (double) (src[i] - minPay) * scale;
+    }
+    return;
+  }
+
+  std::vector<int> profile(numPlayers);
+  for (Gambit::StrategyIterator iter(game); !iter.AtEnd(); iter++) {
+    for (int pl = 1; pl <= numPlayers; pl++) {
+      profile[pl-1] = (*iter)->GetStrategy(pl)->GetNumber() - 1;
+    }
+    for (int pl = 1; pl <= numPlayers; pl++) {
+      setPurePayoff(pl-1, &profile[0],
+		    (double) ((*iter)->GetPayoff(pl) - minPay) * scale);
+    }
+  }
+}
+
+nfgame::nfgame(const nfgame &other)
+  : gnmgame(other.numPlayers, other.actions), payoffs(other.payoffs),
+    storage(other.storage), game(other.game) {
+  initialize();
+}
+
+void nfgame::initialize() {
   blockSize = new int[numPlayers + 1];
   blockSize[0] = 1;
   for(int i = 1; i <= numPlayers; i++) {
     blockSize[i] = blockSize[i-1]*actions[i-1];
   }
+
+  // Level k of the workspace holds blockSize[k+1] entries, and weight
+  // tensor k blockSize[k].  The full tensors are read in place, so the
+  // workspace is needed only below numPlayers-1; the weights are needed
+  // for every player, as the payoffs to the last player's strategies
+  // are computed with the weight tensor of all the players below it.
+  level.resize(numPlayers);
+  weightLevel.resize(numPlayers);
+  int size = 0, weightSize = 0;
+  for(int k = 0; k < numPlayers; k++) {
+    if(k < numPlayers - 1) {
+      level[k] = size;
+      size += blockSize[k+1];
+    }
+    weightLevel[k] = weightSize;
+    weightSize += blockSize[k];
+  }
+  work.resize(size > 0 ? size : 1);
+  weights.resize(weightSize > 0 ? weightSize : 1);
+  probs.resize(numActions);
+  column.resize(maxActions);
 }
 
 nfgame::~nfgame() {
   delete[] blockSize;
 }
 
+void nfgame::setPurePayoff(int player, int *s, double value) {
+  if(!storage.get() || !storage.unique()) {
+    int size = numPlayers * numStrategies;
+    cvector *copy = new cvector(size);
+    memcpy(copy->values(), payoffs, size * sizeof(double));
+    storage.reset(copy);
+    payoffs = storage->values();
+    game = 0;
+  }
+  storage->values()[findIndex(player, s)] = value;
+}
+
 int nfgame::findIndex(int player, int *s) {
   int i, retIndex=player * blockSize[numPlayers];
   for(i = 0; i < numPlayers; i++)
@@ -41,125 +140,118 @@ int nfgame::findIndex(int player, int *s) {
 }
 
 double nfgame::getMixedPayoff(int player, cvector &s) {
-  double *m = new double[blockSize[numPlayers]];
-  try {
-    memcpy(m, payoffs.values() + player * blockSize[numPlayers], blockSize[numPlayers]*sizeof(double));
-    double p = localPayoff(s, m, numPlayers-1);
-    delete [] m;
-    return p;
-  }
-  catch (...) {
-    delete [] m;
-    throw;
-  }
+  setProbs(s);
+  return contractAll(payoffs + player * blockSize[numPlayers], numPlayers);
 }
 
 void nfgame::getPayoffVector(cvector &dest, int player, const cvector &s){
-  vector<double> t(payoffs.values()+player*blockSize[numPlayers], payoffs.values()+(player+1)*blockSize[numPlayers]);
-
-  localPayoffVector(dest.values(), player,const_cast<cvector&>(s),&(t[0]),numPlayers-1);
+  setProbs(s);
+  contractAllBut(dest.values(), payoffs + player * blockSize[numPlayers],
+		 numPlayers-1, player);
 }
 
 void nfgame::payoffMatrix(cmatrix &dest, cvector &s, double fuzz) {
-  int rown, coln, rowi, coli;
+  int rown, coln, rowi, coli, k;
   double fuzzcount;
-  double *m = new double[blockSize[numPlayers]];
-  double *local = new double[maxActions*maxActions];
-  try {
-    for(rown = 0; rown < numPlayers; rown++) {
-      for(coln = 0; coln < numPlayers; coln++) {
-        if(rown == coln) {
-	  fuzzcount = fuzz;
-	  for(rowi=firstAction(rown); rowi < lastAction(rown); rowi++) {
-	    for(coli=firstAction(coln); coli < lastAction(coln); coli++) {
-	      dest[rowi][coli]=fuzzcount;
-	      fuzzcount += fuzz;
-	    }
-	  }
-        } else {
-	  // set m to be the payoffs for player rown
-	  memcpy(m, payoffs.values() + rown * blockSize[numPlayers], blockSize[numPlayers] * sizeof(double));
-	  localPayoffMatrix(local, rown, coln, s, m, numPlayers-1);
-	  for(rowi = firstAction(rown); rowi < lastAction(rown); rowi++) {
-	    for(coli = firstAction(coln); coli < lastAction(coln); coli++) {
-	      if(rown > coln) {
-	        dest[rowi][coli] = *(local + (rowi - firstAction(rown))*actions[coln] + (coli - firstAction(coln)));
-	      } else {
-	        dest[rowi][coli] = *(local + (coli - firstAction(coln))*actions[rown] + (rowi - firstAction(rown)));
-	      }
-	    }
-	  }
-        }
+  setProbs(s);
+  for(rown = 0; rown < numPlayers; rown++) {
+    fuzzcount = fuzz;
+    for(rowi=firstAction(rown); rowi < lastAction(rown); rowi++) {
+      for(coli=firstAction(rown); coli < lastAction(rown); coli++) {
+	dest[rowi][coli]=fuzzcount;
+	fuzzcount += fuzz;
       }
     }
-    delete [] local;
-    delete [] m;
-  }
-  catch (...) {
-    delete [] local;
-    delete [] m;
-    throw;
   }
-}
 
-
-//assumes m = memcpy(m, payoffs + blockSize[numPlayers] * player1, blockSize[numPlayers]*sizeof(double)), player1 != player2
-//i.e. m points to payoff cmatrix for the desired player
-
-void nfgame::localPayoffMatrix(double *dest, int player1, int player2, cvector &s, double *m, int n) {
-  int i;
-  if(player1 == n) {
-    for(i = 0; i < actions[player1]; i++) {
-      localPayoffVector(dest+i*actions[player2], player2, s, m+i*blockSize[player1], n-1);
+  for(rown = 0; rown < numPlayers; rown++) {
+    // m is the payoffs for player rown, contracted over the players above k
+    const double *m = payoffs + rown * blockSize[numPlayers];
+    for(k = numPlayers-1; k > rown; k--) {
+      coln = k;
+      for(coli = 0; coli < actions[coln]; coli++) {
+	contractAllBut(&column[0], m + coli*blockSize[coln], k-1, rown);
+	for(rowi = 0; rowi < actions[rown]; rowi++) {
+	  dest[firstAction(rown)+rowi][firstAction(coln)+coli] = column[rowi];
+	}
+      }
+      m = contractTop(m, k);
     }
-  } else if(player2 == n) {
-    for(i = 0; i < actions[player2]; i++) {
-      localPayoffVector(dest+i*actions[player1], player1, s, m+i*blockSize[player2], n-1);
+
+    // The players below rown are contracted separately for each of its
+    // strategies; each step yields the entries for the player contracted
+    // along with the tensor for the next
+    for(rowi = 0; rowi < actions[rown]; rowi++) {
+      const double *local = m + rowi*blockSize[rown];
+      double *row = dest[firstAction(rown)+rowi];
+      for(coln = rown-1; coln > 0; coln--) {
+	local = contractTop(local, coln, row + firstAction(coln));
+      }
+      if(rown > 0) {
+	memcpy(row, local, actions[0] * sizeof(double));
+      }
     }
-  } else {
-    m = scaleMatrix(s, m, n);
-    localPayoffMatrix(dest, player1, player2, s, m, n-1);
   }
 }
 
-double *nfgame::scaleMatrix(cvector &s, double *m, int n) {
-  int i,j, curbase, newbase = -1;
-  double scale;
-  for(i = 0; i < actions[n]; i++) {
-    if(s[i+firstAction(n)] > 0.0) {
-      scale = s[i+firstAction(n)];
-      curbase = i*blockSize[n];
-      if(newbase < 0) {
-	newbase = curbase;
-	for(j = curbase; j < curbase+blockSize[n]; j++) {
-	  m[j] *= scale;
-	}
-      } else {
-	for(j = 0; j < blockSize[n]; j++) {
-	  m[newbase + j] += scale * m[curbase+j];
-	}
+// Only strategies played with positive probability contribute.  Weight
+// tensor k is the product of the probabilities of players 0..k-1, so
+// its inner product with a tensor over those players contracts them all.
+void nfgame::setProbs(const cvector &s) {
+  for(int i = 0; i < numActions; i++) {
+    probs[i] = (s[i] > 0.0) ? s[i] : 0.0;
+  }
+  weights[weightLevel[0]] = 1.0;
+  for(int k = 1; k < numPlayers; k++) {
+    const double *lower = &weights[weightLevel[k-1]];
+    double *upper = &weights[weightLevel[k]];
+    for(int i = 0; i < actions[k-1]; i++) {
+      double p = probs[firstAction(k-1)+i];
+      for(int j = 0; j < blockSize[k-1]; j++) {
+	upper[i*blockSize[k-1]+j] = p * lower[j];
       }
     }
   }
-  return m+newbase;
 }
 
-void nfgame::localPayoffVector(double *dest, int player, cvector &s, double *m, int n) {
-  if(player == n) {
-    for(int i = 0; i < actions[player]; i++) {
-      dest[i] = localPayoff(s, m+i*blockSize[player], n-1);
-    }
-  } else {
-    m = scaleMatrix(s, m, n);
-    localPayoffVector(dest, player, s, m, n-1);
+// Contracts player k out of src, a tensor over players 0..k, leaving
+// a tensor over players 0..k-1 at level k-1.  If values is not null,
+// the payoff to each strategy of player k, contracting all the players
+// below it, is written there.
+const double *nfgame::contractTop(const double *src, int k, double *values) {
+  double *dest = &work[level[k-1]];
+  Gambit::ContractPayoffs(src, blockSize[k], actions[k],
+			  &probs[firstAction(k)],
+			  (values) ? &weights[weightLevel[k]] : 0,
+			  dest, values);
+  return dest;
+}
+
+// Contracts all players out of src, a tensor over players 0..n-1
+double nfgame::contractAll(const double *src, int n) {
+  for(int k = n-1; k > 0; k--) {
+    src = contractTop(src, k);
+  }
+  if(n == 0) {
+    return *src;
+  }
+  double value = 0.0;
+  for(int i = 0; i < actions[0]; i++) {
+    value += probs[i] * src[i];
   }
+  return value;
 }
 
-double nfgame::localPayoff(cvector &s, double *m, int n) {
-  if(n < 0)
-    return *m;
+// Contracts all players but keep out of src, a tensor over players
+// 0..top, writing the payoff to each strategy of keep to dest
+void nfgame::contractAllBut(double *dest, const double *src, int top, int keep) {
+  for(int k = top; k > keep; k--) {
+    src = contractTop(src, k);
+  }
+  if(keep > 0) {
+    contractTop(src, keep, dest);
+  }
   else {
-    m = scaleMatrix(s, m, n);
-    return localPayoff(s, m, n-1);
+    memcpy(dest, src, actions[0] * sizeof(double));
   }
 }
@@ -20,6 +20,8 @@
 #ifndef __NFGAME_H
 #define __NFGAME_H
 
+#include <vector>
+#include "libgambit/libgambit.h"
 #include "gnmgame.h"
 #include "cmatrix.h"
 
@@ -27,6 +29,15 @@ class nfgame : public gnmgame {
  public:
   friend ostream& operator<< (ostream& s, nfgame& g);
   nfgame(int numPlayers, int *actions, const cvector &payoffs);
+  // Builds the game from a Gambit game.  If normalize is true, payoffs
+  // are rescaled linearly so the smallest is zero and the largest one.
+  // For a table game the payoffs are taken from its dense payoff table,
+  // which has the same layout as ours: without normalization the table
+  // is read in place, and with it the table is rescaled in a single pass.
+  nfgame(const Gambit::Game &game, bool normalize = false);
+  // The copy shares the payoffs of the game, but has working storage of
+  // its own, so the two can be used on different threads
+  nfgame(const nfgame &game);
   ~nfgame();
 
   // Input: s[i] has integer index of player i's pure strategy
@@ -35,9 +46,7 @@ class nfgame : public gnmgame {
     return payoffs[findIndex(player, s)];
   }
 
-  inline void setPurePayoff(int player, int *s, double value) {
-    payoffs[findIndex(player, s)]= value;
-  }
+  void setPurePayoff(int player, int *s, double value);
 
   double getMixedPayoff(int player, cvector &s);
   void payoffMatrix(cmatrix &dest, cvector &s, double fuzz);
@@ -46,13 +55,31 @@ class nfgame : public gnmgame {
   
 
  private:
+  void initialize();
   int findIndex(int player, int *s);
-  void localPayoffMatrix(double *dest, int player1, int player2, cvector &s, double *m, int n);
-  void localPayoffVector(double *dest, int player, cvector &s, double *m, int n);
-  double localPayoff(cvector &s, double *m, int n);
-  double *scaleMatrix(cvector &s, double *m, int n);
-  cvector payoffs;
+
+  // The payoffs of one player form a tensor over the players, the first
+  // player's strategy varying fastest.  Payoffs to pure strategies are
+  // computed by contracting the other players out of the tensor, highest
+  // numbered first, so a partial contraction is shared by all the pairs
+  // of players below it.  Level k of the workspace holds a tensor over
+  // players 0..k; each step reads one level and writes a lower one, so
+  // no call allocates memory.
+  void setProbs(const cvector &s);
+  const double *contractTop(const double *src, int k, double *values = 0);
+  double contractAll(const double *src, int n);
+  void contractAllBut(double *dest, const double *src, int top, int keep);
+
+  // The payoffs of the players, one tensor after another.  They are
+  // either read in place from the table of a Gambit game, which is held
+  // so the table outlives us, or kept in storage shared with copies of
+  // the game; setPurePayoff() takes a private copy before changing them.
+  const double *payoffs;
+  Gambit::shared_ptr<cvector> storage;
+  Gambit::Game game;
   int *blockSize;
+  std::vector<double> work, weights, probs, column;
+  std::vector<int> level, weightLevel;
 };
 inline ostream& operator<< (ostream& s, nfgame& g){
 
@@ -62,7 +89,7 @@ inline ostream& operator<< (ostream& s, nfgame& g){
     s<< g.actions[i];
   }
   s<<endl;
-  s << g.payoffs;
+  for (int i=0;i<g.numPlayers*g.numStrategies;i++) s << g.payoffs[i] << ' ';
   s<<endl;
   return s;
 }
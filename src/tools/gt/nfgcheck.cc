@@ -0,0 +1,226 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/gt/nfgcheck.cc
+// Checks the payoffs computed by nfgame against direct sums over the table
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "cmatrix.h"
+#include "nfgame.h"
+
+//
+// nfgame computes payoffs by contracting the payoff tensors one player
+// at a time.  This program computes the same payoffs by summing over
+// every pure strategy profile, weighted by its probability, on random
+// games of one to four players with up to four strategies each, and
+// on profiles in which some strategies have probability zero.  It
+// reports each disagreement, and exits with a nonzero status if any.
+//
+
+namespace {
+
+/// Returns a pseudo-random number in [0,1), the same on every host
+double Uniform(unsigned long &p_seed)
+{
+  p_seed = (p_seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+  return p_seed / 2147483648.0;
+}
+
+class PayoffChecker {
+private:
+  int m_numPlayers;
+  std::vector<int> m_actions, m_offset;
+  cvector m_payoffs, m_profile;
+  nfgame m_game;
+  int m_failures;
+
+  int NumProfiles(void) const
+  {
+    int count = 1;
+    for (int pl = 0; pl < m_numPlayers; count *= m_actions[pl++]);
+    return count;
+  }
+  /// Sets p_strategy to the strategies in profile p_index, and returns
+  /// its probability, leaving out the players p_skip1 and p_skip2
+  double Decode(int p_index, std::vector<int> &p_strategy,
+		int p_skip1, int p_skip2) const;
+  void Compare(const char *p_what, int p_player, int p_entry,
+	       double p_value, double p_expected);
+
+public:
+  PayoffChecker(int p_numPlayers, int *p_actions, unsigned long &p_seed);
+
+  void CheckPayoffVectors(void);
+  void CheckMixedPayoffs(void);
+  void CheckPayoffMatrix(void);
+  int NumFailures(void) const { return m_failures; }
+};
+
+cvector RandomPayoffs(int p_numPlayers, int *p_actions, unsigned long &p_seed)
+{
+  int size = p_numPlayers;
+  for (int pl = 0; pl < p_numPlayers; size *= p_actions[pl++]);
+  cvector payoffs(size);
+  for (int i = 0; i < size; i++) {
+    payoffs[i] = 20.0 * Uniform(p_seed) - 10.0;
+  }
+  return payoffs;
+}
+
+PayoffChecker::PayoffChecker(int p_numPlayers, int *p_actions,
+			     unsigned long &p_seed)
+  : m_numPlayers(p_numPlayers), m_actions(p_actions, p_actions + p_numPlayers),
+    m_offset(p_numPlayers + 1, 0),
+    m_payoffs(RandomPayoffs(p_numPlayers, p_actions, p_seed)),
+    m_game(p_numPlayers, p_actions, m_payoffs), m_failures(0)
+{
+  for (int pl = 0; pl < m_numPlayers; pl++) {
+    m_offset[pl+1] = m_offset[pl] + m_actions[pl];
+  }
+  m_profile = cvector(m_offset[m_numPlayers]);
+  for (int pl = 0; pl < m_numPlayers; pl++) {
+    double total = 0.0;
+    for (int i = m_offset[pl]; i < m_offset[pl+1]; i++) {
+      m_profile[i] = (Uniform(p_seed) < 0.25) ? 0.0 : Uniform(p_seed);
+      total += m_profile[i];
+    }
+    for (int i = m_offset[pl]; i < m_offset[pl+1]; i++) {
+      m_profile[i] = (total > 0.0) ? m_profile[i] / total : 1.0 / m_actions[pl];
+    }
+  }
+}
+
+double PayoffChecker::Decode(int p_index, std::vector<int> &p_strategy,
+			     int p_skip1, int p_skip2) const
+{
+  double prob = 1.0;
+  for (int pl = 0; pl < m_numPlayers; pl++) {
+    p_strategy[pl] = p_index % m_actions[pl];
+    p_index /= m_actions[pl];
+    if (pl != p_skip1 && pl != p_skip2) {
+      prob *= m_profile[m_offset[pl] + p_strategy[pl]];
+    }
+  }
+  return prob;
+}
+
+void PayoffChecker::Compare(const char *p_what, int p_player, int p_entry,
+			    double p_value, double p_expected)
+{
+  if (std::fabs(p_value - p_expected) > 1.0e-9 * (1.0 + std::fabs(p_expected))) {
+    std::cerr << m_numPlayers << " players:";
+    for (int pl = 0; pl < m_numPlayers; pl++) {
+      std::cerr << ' ' << m_actions[pl];
+    }
+    std::cerr << ": " << p_what << " of player " << p_player
+	      << ", entry " << p_entry << ", is " << p_value
+	      << ", not " << p_expected << std::endl;
+    m_failures++;
+  }
+}
+
+void PayoffChecker::CheckPayoffVectors(void)
+{
+  std::vector<int> strategy(m_numPlayers);
+  for (int pl = 0; pl < m_numPlayers; pl++) {
+    std::vector<double> expected(m_actions[pl], 0.0);
+    for (int index = 0; index < NumProfiles(); index++) {
+      double prob = Decode(index, strategy, pl, -1);
+      expected[strategy[pl]] += prob * m_game.getPurePayoff(pl, &strategy[0]);
+    }
+    cvector payoffs(m_actions[pl]);
+    m_game.getPayoffVector(payoffs, pl, m_profile);
+    for (int i = 0; i < m_actions[pl]; i++) {
+      Compare("payoff vector", pl, i, payoffs[i], expected[i]);
+    }
+  }
+}
+
+void PayoffChecker::CheckMixedPayoffs(void)
+{
+  std::vector<int> strategy(m_numPlayers);
+  for (int pl = 0; pl < m_numPlayers; pl++) {
+    double expected = 0.0;
+    for (int index = 0; index < NumProfiles(); index++) {
+      double prob = Decode(index, strategy, -1, -1);
+      expected += prob * m_game.getPurePayoff(pl, &strategy[0]);
+    }
+    Compare("mixed payoff", pl, 0, m_game.getMixedPayoff(pl, m_profile),
+	    expected);
+  }
+}
+
+//
+// Entry (i, j) of the matrix, for strategies i and j of different
+// players, is the payoff to i when the other player plays j
+//
+void PayoffChecker::CheckPayoffMatrix(void)
+{
+  int numActions = m_offset[m_numPlayers];
+  cmatrix matrix(numActions, numActions);
+  m_game.payoffMatrix(matrix, m_profile, 0.0);
+
+  std::vector<int> strategy(m_numPlayers);
+  for (int row = 0; row < m_numPlayers; row++) {
+    for (int col = 0; col < m_numPlayers; col++) {
+      if (row == col) continue;
+      std::vector<double> expected(m_actions[row] * m_actions[col], 0.0);
+      for (int index = 0; index < NumProfiles(); index++) {
+	double prob = Decode(index, strategy, row, col);
+	expected[strategy[row] * m_actions[col] + strategy[col]] +=
+	  prob * m_game.getPurePayoff(row, &strategy[0]);
+      }
+      for (int i = 0; i < m_actions[row]; i++) {
+	for (int j = 0; j < m_actions[col]; j++) {
+	  Compare("payoff matrix", row, i * numActions + m_offset[col] + j,
+		  matrix[m_offset[row] + i][m_offset[col] + j],
+		  expected[i * m_actions[col] + j]);
+	}
+      }
+    }
+  }
+}
+
+}  // end anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  unsigned long seed = 1;
+  int failures = 0, games = 0;
+  int actions[4];
+  for (int numPlayers = 1; numPlayers <= 4; numPlayers++) {
+    for (int trial = 0; trial < 20; trial++) {
+      for (int pl = 0; pl < numPlayers; pl++) {
+	actions[pl] = 1 + (int) (4.0 * Uniform(seed));
+      }
+      PayoffChecker checker(numPlayers, actions, seed);
+      checker.CheckPayoffVectors();
+      checker.CheckMixedPayoffs();
+      checker.CheckPayoffMatrix();
+      failures += checker.NumFailures();
+      games++;
+    }
+  }
+
+  std::cout << games << " games checked, " << failures << " failures" << std::endl;
+  return (failures > 0) ? 1 : 0;
+}
@@ -25,8 +25,16 @@
 #include <cmath>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <cerrno>
+#include <cstdlib>
+#include <climits>
+#include <ctime>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
 #include "libgambit/libgambit.h"
+#include "libgambit/multistart.h"
 
 #include "nfgame.h"
 #include "aggame.h"
@@ -45,6 +53,9 @@ const double THRESHOLD = 1e-2;
 int g_numDecimals = 6;
 bool g_verbose = false;
 int g_numVectors = 1;
+int g_numThreads = 1;
+int g_factorFreq = 0;
+bool g_uniqueEquilibria = false;
 std::string g_startFile;
 
 bool ReadProfile(std::istream &p_stream, cvector &p_profile)
@@ -86,77 +97,94 @@ void PrintHelp(char *progname)
 
   std::cerr << "Options:\n";
   std::cerr << "  -d DECIMALS      show equilibria as floating point with DECIMALS digits\n";
+  std::cerr << "  -f STEPS         LU factor the Jacobian every STEPS steps, with Broyden\n";
+  std::cerr << "                   updates in between (default 0: exact adjoint each step)\n";
   std::cerr << "  -h, --help       print this help message\n";
+  std::cerr << "  -j THREADS       number of threads to run perturbations on (default 1)\n";
   std::cerr << "  -n COUNT         number of perturbation vectors to generate\n";
   std::cerr << "  -s FILE          file containing perturbation vectors\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
+  std::cerr << "  -u               report each distinct equilibrium only once\n";
   std::cerr << "  -V, --verbose    verbose mode (shows intermediate output)\n";
   std::cerr << "  -v, --version    print version information\n";
   std::cerr << "                   (default is to only show equilibria)\n";
   exit(1);
 }
 
+//
+// Follows the path from each of a list of perturbation rays
+//
+class GNMWorker : public Gambit::MultiStartWorker {
+private:
+  gnmgame *m_game;
+  const Gambit::List<cvector> *m_perts;
+
+public:
+  GNMWorker(gnmgame &p_game, const Gambit::List<cvector> &p_perts)
+    : m_game(&p_game), m_perts(&p_perts) { }
+  virtual ~GNMWorker() { }
+
+  void Run(int p_start, Gambit::MultiStartOutput &p_output);
+};
+
+void GNMWorker::Run(int p_start, Gambit::MultiStartOutput &p_output)
+{
+  cvector g((*m_perts)[p_start + 1]);
+  if (g_verbose) {
+    PrintProfile(p_output.GetStream(), "pert", g);
+  }
+
+  cvector **answers;
+  gnmstats stats;
+  int numEq = GNM(*m_game, g, answers, STEPS, FUZZ, LNMFREQ, LNMMAX,
+		  LAMBDAMIN, WOBBLE, THRESHOLD, g_factorFreq, stats, p_output);
+  if (g_verbose) {
+    // Written in one piece, as other threads may be writing too
+    std::ostringstream counts;
+    counts << "gnm(): " << stats.factorizations << " factorizations, "
+	   << stats.updates << " updates, " << stats.adjoints << " adjoints\n";
+    std::cerr << counts.str();
+  }
+  for (int i = 0; i < numEq; i++) {
+    free(answers[i]);
+  }
+  free(answers);
+}
+
 void Solve(const Gambit::Game &p_game)
 {
   int i;
+  clock_t setupStart = clock();
   gnmgame *A=NULL;
   if (p_game->IsAgg()){
 	  A = new aggame(dynamic_cast<Gambit::GameAggRep &>(*p_game));
   }
   else {
-    Gambit::Rational maxPay = p_game->GetMaxPayoff();
-    Gambit::Rational minPay = p_game->GetMinPayoff();
-    double scale = 1.0 / (maxPay - minPay);
-
-    int *actions = new int[p_game->NumPlayers()];
-    int veclength = p_game->NumPlayers();
-    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-      actions[pl-1] = p_game->GetPlayer(pl)->NumStrategies();
-      veclength *= p_game->GetPlayer(pl)->NumStrategies();
-    }
-    cvector payoffs(veclength);
-  
-    A = new nfgame(p_game->NumPlayers(), actions, payoffs);
-  
-    int *profile = new int[p_game->NumPlayers()];
-    for (Gambit::StrategyIterator iter(p_game); !iter.AtEnd(); iter++) {
-      for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-        profile[pl-1] = (*iter)->GetStrategy(pl)->GetNumber() - 1;
-      }
-
-      for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-        A->setPurePayoff(pl-1, profile,
-		       (double) ((*iter)->GetPayoff(pl) - minPay) *
-		       scale);
-      }
-    }
+    A = new nfgame(p_game, true);
+  }
+  if (g_verbose) {
+    std::cerr << "Game setup took "
+	      << (double) (clock() - setupStart) / CLOCKS_PER_SEC
+	      << " seconds" << std::endl;
   }
 
+  // Perturbation rays are all chosen before any are followed, so the
+  // sequence of random numbers, and the output, do not depend on the threads
+  Gambit::List<cvector> perts;
   cvector g(A->getNumActions()); // choose a random perturbation ray
-  int numEq;
 
   if (g_startFile != "") {
     std::ifstream startVectors(g_startFile.c_str());
 
     while (!startVectors.eof() && !startVectors.bad()) {
-      cvector **answers;
       if (ReadProfile(startVectors, g)) {
 	g /= g.norm(); // normalized
-	if (g_verbose) {
-	  PrintProfile(std::cout, "pert", g);
-	}
-
-	numEq = GNM(*A, g, answers, STEPS, FUZZ, LNMFREQ, LNMMAX, LAMBDAMIN, WOBBLE, THRESHOLD);
-	for (i = 0; i < numEq; i++) {
-	  free(answers[i]);
-	}
-	free(answers);
+	perts.Append(g);
       }
     }
   }
   else {
     for (int iter = 0; iter < g_numVectors; iter++) {
-      cvector **answers;
       for(i = 0; i < A->getNumActions(); i++) {
 #if !defined(HAVE_DRAND48)
 	g[i] = rand();
@@ -165,18 +193,44 @@ void Solve(const Gambit::Game &p_game)
 #endif  // HAVE_DRAND48
       }
       g /= g.norm(); // normalized
-      if (g_verbose) {
-	PrintProfile(std::cout, "pert", g);
-      }
-      numEq = GNM(*A, g, answers, STEPS, FUZZ, LNMFREQ, LNMMAX, LAMBDAMIN, WOBBLE, THRESHOLD);
-      for (i = 0; i < numEq; i++) {
-	free(answers[i]);
-      }
-      free(answers);
+      perts.Append(g);
     }
   }
 
-  delete A;
+  // An nfgame contracts payoffs in working storage of its own, so each
+  // thread follows paths on its own copy; the copies share the payoffs.
+  // An aggame keeps working state between calls as well, and paths on one
+  // are followed on a single thread.
+  int numThreads = std::max(1, std::min(g_numThreads, perts.Length()));
+  if (p_game->IsAgg()) {
+    numThreads = 1;
+  }
+  std::vector<gnmgame *> games(1, A);
+  std::vector<GNMWorker> workers;
+  std::vector<Gambit::MultiStartWorker *> pointers;
+  try {
+    for (i = 1; i < numThreads; i++) {
+      games.push_back(new nfgame(*static_cast<nfgame *>(A)));
+    }
+    for (i = 0; i < numThreads; i++) {
+      workers.push_back(GNMWorker(*games[i], perts));
+    }
+    for (i = 0; i < numThreads; i++) {
+      pointers.push_back(&workers[i]);
+    }
+
+    Gambit::MultiStartRunner runner(std::cout, g_uniqueEquilibria);
+    runner.Run(perts.Length(), pointers);
+  }
+  catch (...) {
+    for (size_t j = 0; j < games.size(); j++) {
+      delete games[j];
+    }
+    throw;
+  }
+  for (size_t j = 0; j < games.size(); j++) {
+    delete games[j];
+  }
 }
 
 int main(int argc, char *argv[])
@@ -192,7 +246,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:n:s:qvVhS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:f:n:s:qvVhSj:u", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -205,12 +259,28 @@ int main(int argc, char *argv[])
     case 'd':
       g_numDecimals = atoi(optarg);
       break;
+    case 'f':
+      g_factorFreq = atoi(optarg);
+      break;
     case 'n':
       g_numVectors = atoi(optarg);
       break;
     case 's':
       g_startFile = optarg;
       break;
+    case 'j': {
+      char *end;
+      long threads = strtol(optarg, &end, 10);
+      if (end == optarg || *end != '\0' || threads < 1 || threads > INT_MAX) {
+	std::cerr << argv[0] << ": Number of threads must be a positive integer.\n";
+	PrintHelp(argv[0]);
+      }
+      g_numThreads = (int) threads;
+      break;
+    }
+    case 'u':
+      g_uniqueEquilibria = true;
+      break;
     case 'S':
       break;
     case 'h':
@@ -255,6 +325,10 @@ int main(int argc, char *argv[])
     std::cerr << "Error: Game not in a recognized format.\n";
     return 1;
   }
+  catch (std::runtime_error &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
   catch (...) {
     std::cerr << "Error: An internal error occurred.\n";
     return 1;
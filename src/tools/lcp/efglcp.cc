@@ -24,13 +24,14 @@
 #include <cstdio>
 #include <unistd.h>
 #include <iostream>
+#include <set>
 #include "libgambit/libgambit.h"
+#include "libgambit/gametree.h"
 #include "efglcp.h"
 
 using namespace Gambit;
 
-#include "lhtab.h"
-#include "lemketab.h"
+#include "sparsetab.h"
 
 template <class T> class NashLcpBehavSolver<T>::Solution {
 public:
@@ -41,13 +42,28 @@ public:
   List<BFS<T> > m_list;
   List<MixedBehavProfile<T> > m_equilibria;
 
-  bool AddBFS(const LTableau<T> &);
+  /// @name Sequence form index
+  //@{
+  /// The tree, flattened, on which the sequence form is indexed
+  const GameTreeFlatView *tree;
+  /// Position of each information set in isets1 (isets2) by number
+  Array<int> isetIndex1, isetIndex2;
+  /// Sequence preceding the first sequence at each listed infoset
+  Array<int> seqStart1, seqStart2;
+  /// Index in the support of each action of the tree, or zero
+  Array<int> supportIndex;
+  /// Sequence of each player leading to each node, or zero if the node
+  /// is not reached under the support
+  Array<int> nodeSeq1, nodeSeq2;
+  //@}
+
+  bool AddBFS(const SparseLTableau<T> &);
 
   int EquilibriumCount(void) const { return m_equilibria.size(); }
 };
 
 template <class T> bool 
-NashLcpBehavSolver<T>::Solution::AddBFS(const LTableau<T> &tableau)
+NashLcpBehavSolver<T>::Solution::AddBFS(const SparseLTableau<T> &tableau)
 {
   BFS<T> cbfs;
   Vector<T> v(tableau.MinRow(), tableau.MaxRow());
@@ -78,7 +94,6 @@ template <class T> List<MixedBehavProfile<T> >
 NashLcpBehavSolver<T>::Solve(const BehavSupport &p_support) const
 {
   BFS<T> cbfs;
-  int i, j;
   Solution solution;
 
   solution.isets1 = p_support.ReachableInfosets(p_support.GetGame()->GetPlayer(1));
@@ -92,39 +107,23 @@ NashLcpBehavSolver<T>::Solve(const BehavSupport &p_support) const
 
   ntot = solution.ns1+solution.ns2+solution.ni1+solution.ni2;
 
-  Matrix<T> A(1,ntot,0,ntot);
-  Vector<T> b(1,ntot);
-
   solution.maxpay = p_support.GetGame()->GetMaxPayoff() + Rational(1);
 
-  T prob = (T)1;
-  for (i = A.MinRow(); i <= A.MaxRow(); i++) {
-    b[i] = (T) 0;
-    for (j = A.MinCol(); j <= A.MaxCol(); j++) {
-      A(i,j) = (T) 0; 
-    }
-  }
+  SparseMatrix<T> M;
+  BuildSequenceForm(p_support, M, solution);
+  Vector<T> d(1,ntot), q(1,ntot);
+  d = -(T) 1;
+  q = (T) 0;
+  q[solution.ns1+solution.ns2+1] = -(T)1;
+  q[solution.ns1+solution.ns2+solution.ni1+1] = -(T)1;
 
-  FillTableau(p_support, A, p_support.GetGame()->GetRoot(), prob, 1, 1, 0, 0,
-	      solution);
-  for (i = A.MinRow(); i <= A.MaxRow(); i++) { 
-    A(i,0) = -(T) 1;
-  }
-  A(1,solution.ns1+solution.ns2+1) = (T) 1;
-  A(solution.ns1+solution.ns2+1,1) = -(T) 1;
-  A(solution.ns1+1,solution.ns1+solution.ns2+solution.ni1+1) = (T) 1;
-  A(solution.ns1+solution.ns2+solution.ni1+1,solution.ns1+1) = -(T) 1;
-  b[solution.ns1+solution.ns2+1] = -(T)1;
-  b[solution.ns1+solution.ns2+solution.ni1+1] = -(T)1;
-
-  LTableau<T> tab(A,b);
+  SparseLTableau<T> tab(M, d, q);
   solution.eps = tab.Epsilon();
   
   try {
     if (m_stopAfter != 1) {
       try {
-	AllLemke(p_support, solution.ns1+solution.ns2+1, 
-		 tab, 0, A, solution);
+	AllLemke(p_support, solution.ns1+solution.ns2+1, tab, 0, solution);
       }
       catch (NashEquilibriumLimitReached &) {
 	// Just handle this silently; equilibria are already printed
@@ -140,9 +139,7 @@ NashLcpBehavSolver<T>::Solve(const BehavSupport &p_support) const
       
       solution.AddBFS(tab);
       tab.BasisVector(sol);
-      GetProfile(p_support, tab, 
-		 profile,sol,p_support.GetGame()->GetRoot(), 1, 1,
-		 solution);
+      GetProfile(tab, profile, sol, solution);
       profile.UndefinedToCentroid();
       solution.m_equilibria.push_back(profile);
       this->m_onEquilibrium->Render(profile);
@@ -164,8 +161,7 @@ NashLcpBehavSolver<T>::Solve(const BehavSupport &p_support) const
 //
 template <class T> void
 NashLcpBehavSolver<T>::AllLemke(const BehavSupport &p_support,
-				int j, LTableau<T> &B, int depth,
-				Matrix<T> &A,
+				int j, SparseLTableau<T> &B, int depth,
 				Solution &p_solution) const
 {
   if (m_maxDepth != 0 && depth > m_maxDepth) {
@@ -181,8 +177,8 @@ NashLcpBehavSolver<T>::AllLemke(const BehavSupport &p_support,
   for (int i = B.MinRow(); i <= B.MaxRow() && !newsol; i++) {
     if (i == j) continue;
 
-    LTableau<T> BCopy(B);
-    A(i,0) = -small_num;
+    SparseLTableau<T> BCopy(B);
+    BCopy.SetCovering(i, -small_num);
     BCopy.Refactor();
 
     int missing;
@@ -199,9 +195,7 @@ NashLcpBehavSolver<T>::AllLemke(const BehavSupport &p_support,
     if (BCopy.SF_LCPPath(-missing) == 1) {
       newsol = p_solution.AddBFS(BCopy);
       BCopy.BasisVector(sol);
-      GetProfile(p_support, BCopy, profile, sol,
-		 p_support.GetGame()->GetRoot(), 1, 1,
-		 p_solution);
+      GetProfile(BCopy, profile, sol, p_solution);
       profile.UndefinedToCentroid();
       if (newsol) {
 	this->m_onEquilibrium->Render(profile);
@@ -215,149 +209,235 @@ NashLcpBehavSolver<T>::AllLemke(const BehavSupport &p_support,
       // gout << ": Dead End";
     }
       
-    A(i,0) = (T) -1;
+    BCopy.SetCovering(i, (T) -1);
     if (newsol) {
       BCopy.Refactor();
-      AllLemke(p_support, i, BCopy, depth+1, A, p_solution);
+      AllLemke(p_support, i, BCopy, depth+1, p_solution);
     }
   }
 }
 
+namespace {
+
+//
+// Returns whether p_seq is the sequence of one of the actions at an
+// information set whose sequences follow p_start.  Under absent-mindedness
+// an information set may be reached by one of its own actions; the entry
+// of that action then stands in the place of the one for the sequence
+// leading to the information set.
+//
+bool IsActionSequence(int p_seq, int p_start, int p_actions)
+{
+  return (p_seq > p_start && p_seq <= p_start + p_actions);
+}
+
+}  // end anonymous namespace
+
+//
+// Builds the sequence form of the game in a single preorder pass over
+// the flattened tree.  The sequence of each player leading to a node is
+// inherited from its parent, or is the sequence of the support action
+// taken at the parent; sequences at an information set are numbered
+// consecutively from seqStart, in the order of the reachable information
+// sets.  Nodes not reached under the support have sequence zero, and their
+// subtrees are skipped.  The entries of the matrix are collected by a
+// sparse builder: the payoff blocks are summed exactly over the nodes
+// sharing a pair of sequences, and the constraints of each information
+// set are entered once, for its actions, and once for each sequence
+// leading to it, of which there is only one under perfect recall.
+//
 template <class T>
-void NashLcpBehavSolver<T>::FillTableau(const BehavSupport &p_support, 
-					Matrix<T> &A,
-					const GameNode &n, T prob,
-					int s1, int s2, int i1, int i2,
-					Solution &p_solution) const
+void NashLcpBehavSolver<T>::BuildSequenceForm(const BehavSupport &p_support,
+					      SparseMatrix<T> &M,
+					      Solution &p_solution) const
 {
-  int snew;
+  const GameTreeFlatView &tree =
+    dynamic_cast<GameTreeRep *>(p_support.GetGame().operator->())->GetFlatTree();
+  p_solution.tree = &tree;
+
   int ns1 = p_solution.ns1;
   int ns2 = p_solution.ns2;
   int ni1 = p_solution.ni1;
-  int ni2 = p_solution.ni2;
-
-  GameOutcome outcome = n->GetOutcome();
-  if (outcome) {
-    A(s1,ns1+s2) = Rational(A(s1,ns1+s2)) +
-      Rational(prob) * (outcome->GetPayoff<Rational>(1) - p_solution.maxpay);
-    A(ns1+s2,s1) = Rational(A(ns1+s2,s1)) +
-      Rational(prob) * (outcome->GetPayoff<Rational>(2) - p_solution.maxpay);
+  int ntot = ns1 + ns2 + ni1 + p_solution.ni2;
+
+  Array<int> &isetIndex1 = p_solution.isetIndex1;
+  Array<int> &isetIndex2 = p_solution.isetIndex2;
+  Array<int> &seqStart1 = p_solution.seqStart1;
+  Array<int> &seqStart2 = p_solution.seqStart2;
+  isetIndex1 = Array<int>(p_support.GetGame()->GetPlayer(1)->NumInfosets());
+  isetIndex2 = Array<int>(p_support.GetGame()->GetPlayer(2)->NumInfosets());
+  for (int i = 1; i <= isetIndex1.Length(); isetIndex1[i++] = 0);
+  for (int i = 1; i <= isetIndex2.Length(); isetIndex2[i++] = 0);
+  seqStart1 = Array<int>(p_solution.isets1.Length());
+  seqStart2 = Array<int>(p_solution.isets2.Length());
+  for (int i = 1, snew = 1; i <= p_solution.isets1.Length(); i++) {
+    isetIndex1[p_solution.isets1[i]->GetNumber()] = i;
+    seqStart1[i] = snew;
+    snew += p_support.NumActions(1, p_solution.isets1[i]->GetNumber());
+  }
+  for (int i = 1, snew = 1; i <= p_solution.isets2.Length(); i++) {
+    isetIndex2[p_solution.isets2[i]->GetNumber()] = i;
+    seqStart2[i] = snew;
+    snew += p_support.NumActions(2, p_solution.isets2[i]->GetNumber());
   }
-  if (n->GetInfoset()) {
-    if (n->GetPlayer()->IsChance()) {
-      GameInfoset infoset = n->GetInfoset();
-      for (int i = 1; i <= n->NumChildren(); i++) {
-	FillTableau(p_support, A, n->GetChild(i),
-		    Rational(prob) * infoset->GetActionProb(i, Rational(0)),
-		    s1, s2, i1, i2, p_solution);
+
+  Array<int> &supportIndex = p_solution.supportIndex;
+  supportIndex = Array<int>(tree.NumActions());
+  for (int a = 1; a <= tree.NumActions(); supportIndex[a++] = 0);
+  for (int i = 1; i <= tree.NumInfosets(); i++) {
+    int pl = tree.GetInfosetPlayer(i);
+    if (pl == 1 || pl == 2) {
+      int iset = tree.GetInfosetNumber(i);
+      for (int j = 1; j <= p_support.NumActions(pl, iset); j++) {
+	supportIndex[tree.GetFirstAction(i) + 
+		     p_support.GetAction(pl, iset, j)->GetNumber() - 1] = j;
+      }
+    }
+  }
+
+  Array<int> &nodeSeq1 = p_solution.nodeSeq1;
+  Array<int> &nodeSeq2 = p_solution.nodeSeq2;
+  nodeSeq1 = Array<int>(tree.NumNodes());
+  nodeSeq2 = Array<int>(tree.NumNodes());
+  for (int n = 1; n <= tree.NumNodes(); n++) {
+    nodeSeq1[n] = nodeSeq2[n] = 0;
+  }
+  Array<bool> visited1(seqStart1.Length()), visited2(seqStart2.Length());
+  for (int i = 1; i <= visited1.Length(); visited1[i++] = false);
+  for (int i = 1; i <= visited2.Length(); visited2[i++] = false);
+  std::set<std::pair<int, int> > parents;
+  std::vector<Rational> prob(tree.NumNodes() + 1);
+  SparseMatrixBuilder<Rational> entries(ntot, ntot);
+
+  // The constraints on the empty sequences
+  entries.Add(1, ns1+ns2+1, Rational(1));
+  entries.Add(ns1+ns2+1, 1, Rational(-1));
+  entries.Add(ns1+1, ns1+ns2+ni1+1, Rational(1));
+  entries.Add(ns1+ns2+ni1+1, ns1+1, Rational(-1));
+
+  nodeSeq1[1] = nodeSeq2[1] = 1;
+  prob[1] = Rational(1);
+  for (int n = 1; n <= tree.NumNodes(); n++) {
+    if (n > 1) {
+      int parent = tree.GetParent(n), action = tree.GetPriorAction(n);
+      int infoset = tree.GetInfoset(parent);
+      int pl = tree.GetInfosetPlayer(infoset);
+      if (pl != 0 && supportIndex[action] == 0) {
+	n = tree.GetSubtreeEnd(n);
+	continue;
+      }
+      nodeSeq1[n] = nodeSeq1[parent];
+      nodeSeq2[n] = nodeSeq2[parent];
+      prob[n] = prob[parent];
+      if (pl == 0) {
+	prob[n] *= tree.GetChanceProb(action, Rational(0));
+      }
+      else if (pl == 1) {
+	nodeSeq1[n] = seqStart1[isetIndex1[tree.GetInfosetNumber(infoset)]] +
+	  supportIndex[action];
       }
+      else {
+	nodeSeq2[n] = seqStart2[isetIndex2[tree.GetInfosetNumber(infoset)]] +
+	  supportIndex[action];
+      }
+    }
+
+    int s1 = nodeSeq1[n], s2 = nodeSeq2[n];
+    GameOutcome outcome = tree.GetNode(n)->GetOutcome();
+    if (outcome) {
+      entries.Add(s1, ns1+s2,
+		  prob[n] * (outcome->GetPayoff<Rational>(1) - p_solution.maxpay));
+      entries.Add(ns1+s2, s1,
+		  prob[n] * (outcome->GetPayoff<Rational>(2) - p_solution.maxpay));
     }
-    int pl = n->GetPlayer()->GetNumber();
-    if (pl==1) {
-      i1=p_solution.isets1.Find(n->GetInfoset());
-      snew=1;
-      for (int i = 1; i < i1; i++) {
-	snew+=p_support.NumActions(p_solution.isets1[i]->GetPlayer()->GetNumber(),
-				   p_solution.isets1[i]->GetNumber());
+
+    int infoset = tree.GetInfoset(n);
+    if (infoset == 0) continue;
+    int pl = tree.GetInfosetPlayer(infoset);
+    int iset = tree.GetInfosetNumber(infoset);
+    if (pl == 1) {
+      int i1 = isetIndex1[iset], snew = seqStart1[i1];
+      if (!IsActionSequence(s1, snew, p_support.NumActions(pl, iset)) &&
+	  parents.insert(std::make_pair(s1, ns1+ns2+i1+1)).second) {
+	entries.Add(s1, ns1+ns2+i1+1, Rational(-1));
+	entries.Add(ns1+ns2+i1+1, s1, Rational(1));
       }
-      A(s1,ns1+ns2+i1+1) = -(T)1;
-      A(ns1+ns2+i1+1,s1) = (T)1;
-      for (int i = 1; i <= p_support.NumActions(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber()); i++) {
-	A(snew+i,ns1+ns2+i1+1) = (T)1;
-	A(ns1+ns2+i1+1,snew+i) = -(T)1;
-	FillTableau(p_support, A, n->GetChild(p_support.GetAction(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber(), i)->GetNumber()),prob,snew+i,s2,i1,i2, p_solution);
+      if (visited1[i1])  continue;
+      visited1[i1] = true;
+      for (int i = 1; i <= p_support.NumActions(pl, iset); i++) {
+	entries.Add(snew+i, ns1+ns2+i1+1, Rational(1));
+	entries.Add(ns1+ns2+i1+1, snew+i, Rational(-1));
       }
     }
-    if(pl==2) {
-      i2=p_solution.isets2.Find(n->GetInfoset());
-      snew=1;
-      for (int i = 1; i < i2; i++) {
-	snew+=p_support.NumActions(p_solution.isets2[i]->GetPlayer()->GetNumber(),
-				   p_solution.isets2[i]->GetNumber());
+    else if (pl == 2) {
+      int i2 = isetIndex2[iset], snew = seqStart2[i2];
+      if (!IsActionSequence(s2, snew, p_support.NumActions(pl, iset)) &&
+	  parents.insert(std::make_pair(ns1+s2, ns1+ns2+ni1+i2+1)).second) {
+	entries.Add(ns1+s2, ns1+ns2+ni1+i2+1, Rational(-1));
+	entries.Add(ns1+ns2+ni1+i2+1, ns1+s2, Rational(1));
       }
-      A(ns1+s2,ns1+ns2+ni1+i2+1) = -(T)1;
-      A(ns1+ns2+ni1+i2+1,ns1+s2) = (T)1;
-      for (int i = 1; i <= p_support.NumActions(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber()); i++) {
-	A(ns1+snew+i,ns1+ns2+ni1+i2+1) = (T)1;
-	A(ns1+ns2+ni1+i2+1,ns1+snew+i) = -(T)1;
-	FillTableau(p_support, A, n->GetChild(p_support.GetAction(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber(), i)->GetNumber()),prob,s1,snew+i,i1,i2, p_solution);
+      if (visited2[i2])  continue;
+      visited2[i2] = true;
+      for (int i = 1; i <= p_support.NumActions(pl, iset); i++) {
+	entries.Add(ns1+snew+i, ns1+ns2+ni1+i2+1, Rational(1));
+	entries.Add(ns1+ns2+ni1+i2+1, ns1+snew+i, Rational(-1));
       }
     }
-    
   }
-}
 
+  entries.Build(M);
+}
 
+//
+// Recovers the behavior profile from the basis of the tableau.  The
+// probability of each support action at a reached node is the ratio of
+// the weight on the sequence it extends to the weight on the sequence
+// leading to the node.
+//
 template <class T>
-void NashLcpBehavSolver<T>::GetProfile(const BehavSupport &p_support,
-				       const LTableau<T> &tab, 
+void NashLcpBehavSolver<T>::GetProfile(const SparseLTableau<T> &tab, 
 				       MixedBehavProfile<T> &v, 
 				       const Vector<T> &sol,
-				       const GameNode &n, int s1, int s2,
-				       Solution &p_solution) const
+				       const Solution &p_solution) const
 {
+  const GameTreeFlatView &tree = *p_solution.tree;
   int ns1 = p_solution.ns1;
-  int ns2 = p_solution.ns2;
-
-  if (n->GetInfoset()) {
-    int pl = n->GetPlayer()->GetNumber();
-    int iset = n->GetInfoset()->GetNumber();
 
-    if (n->GetPlayer()->IsChance()) {
-      for (int i = 1; i <= n->NumChildren(); i++) {
-	GetProfile(p_support, tab, v, sol, n->GetChild(i), s1, s2,
-		   p_solution);
-      }
+  for (int n = 1; n <= tree.NumNodes(); n++) {
+    if (p_solution.nodeSeq1[n] == 0) {
+      n = tree.GetSubtreeEnd(n);
+      continue;
     }
-    else if (pl == 1) {
-      int inf = p_solution.isets1.Find(n->GetInfoset());
-      int snew = 1;
-      for (int i = 1; i < inf; i++) {
-	snew += p_support.NumActions(1, p_solution.isets1[i]->GetNumber()); 
-      }
-      
-      for (int i = 1; i <= p_support.NumActions(pl, iset); i++) {
-	v(pl,inf,i) = (T) 0;
-	if (tab.Member(s1)) {
-	  int ind = tab.Find(s1);
-	  if (sol[ind] > p_solution.eps) {
-	    if (tab.Member(snew+i)) {
-	      int ind2 = tab.Find(snew+i);
-	      if (sol[ind2] > p_solution.eps) {
-		v(pl,inf,i) = sol[ind2] / sol[ind];
-	      }
-	    }
-	  } 
-	} 
-	GetProfile(p_support, tab, v, sol,
-		   n->GetChild(p_support.GetAction(pl, iset, i)->GetNumber()),
-		   snew+i, s2, p_solution);
-      }
+    int infoset = tree.GetInfoset(n);
+    if (infoset == 0) continue;
+    int pl = tree.GetInfosetPlayer(infoset);
+    if (pl != 1 && pl != 2) continue;
+    int iset = tree.GetInfosetNumber(infoset);
+    int inf, s, snew;
+    if (pl == 1) {
+      inf = p_solution.isetIndex1[iset];
+      s = p_solution.nodeSeq1[n];
+      snew = p_solution.seqStart1[inf];
+    }
+    else {
+      inf = p_solution.isetIndex2[iset];
+      s = ns1 + p_solution.nodeSeq2[n];
+      snew = ns1 + p_solution.seqStart2[inf];
     }
-    else if (pl == 2) { 
-      int inf = p_solution.isets2.Find(n->GetInfoset());
-      int snew = 1;
-      for (int i = 1; i < inf; i++) {
-	snew += p_support.NumActions(2, p_solution.isets2[i]->GetNumber()); 
-      }
 
-      for (int i = 1; i<= p_support.NumActions(pl, iset); i++) {
-	v(pl,inf,i) = (T) 0;
-	if (tab.Member(ns1+s2)) {
-	  int ind = tab.Find(ns1+s2);
-	  if (sol[ind] > p_solution.eps) {
-	    if (tab.Member(ns1+snew+i)) {
-	      int ind2 = tab.Find(ns1+snew+i);
-	      if (sol[ind2] > p_solution.eps) {
-		v(pl,inf,i) = sol[ind2] / sol[ind];
-	      }
+    for (int i = 1; i <= v.GetSupport().NumActions(pl, iset); i++) {
+      v(pl,inf,i) = (T) 0;
+      if (tab.Member(s)) {
+	int ind = tab.Find(s);
+	if (sol[ind] > p_solution.eps) {
+	  if (tab.Member(snew+i)) {
+	    int ind2 = tab.Find(snew+i);
+	    if (sol[ind2] > p_solution.eps) {
+	      v(pl,inf,i) = sol[ind2] / sol[ind];
 	    }
-	  } 
+	  }
 	} 
-	GetProfile(p_support, tab, v, sol,
-		   n->GetChild(p_support.GetAction(pl, iset, i)->GetNumber()),
-		   s1, snew+i, p_solution);
-      }
+      } 
     }
   }
 }
@@ -27,7 +27,8 @@
 
 using namespace Gambit;
 
-template <class T> class LTableau;
+template <class T> class SparseMatrix;
+template <class T> class SparseLTableau;
 
 template <class T> class NashLcpBehavSolver : public NashBehavSolver<T> {
 public:
@@ -44,14 +45,12 @@ private:
 
   class Solution;
 
-  void FillTableau(const BehavSupport &, Matrix<T> &, const GameNode &, T,
-		   int, int, int, int, Solution &) const;
-  void AllLemke(const BehavSupport &, int dup, LTableau<T> &B,
-	       int depth, Matrix<T> &, Solution &) const; 
-  void GetProfile(const BehavSupport &, const LTableau<T> &tab, 
-		  MixedBehavProfile<T> &, const Vector<T> &, 
-		  const GameNode &n, int, int,
-		  Solution &) const;
+  void BuildSequenceForm(const BehavSupport &, SparseMatrix<T> &,
+			 Solution &) const;
+  void AllLemke(const BehavSupport &, int dup, SparseLTableau<T> &B,
+	       int depth, Solution &) const; 
+  void GetProfile(const SparseLTableau<T> &tab, MixedBehavProfile<T> &,
+		  const Vector<T> &, const Solution &) const;
 };
 
 
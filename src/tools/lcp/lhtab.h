@@ -61,6 +61,10 @@ public:
   
       // raw Tableau functions
   void Refactor();
+
+      // basis-only state: the tableau is recovered from the bases alone
+  void GetBasis(Basis &, Basis &) const;
+  void SetBasis(const Basis &, const Basis &);
   
       // miscellaneous functions
   BFS<T> GetBFS(void);
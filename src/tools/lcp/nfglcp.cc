@@ -23,8 +23,15 @@
 #include <cstdio>
 #include <unistd.h>
 #include <iostream>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "libgambit/libgambit.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif  // HAVE_PTHREAD_H
 #include "nfglcp.h"
 #include "lhtab.h"
 
@@ -70,6 +77,26 @@ NashLcpStrategySolver<T>::OnBFS(const StrategySupport &p_support,
   }
   p_solution.push_back(cbfs);
 
+  if (!OnEquilibrium(p_support, cbfs, p_solution)) {
+    return false;
+  }
+
+  if (m_stopAfter > 0 && p_solution.EquilibriumCount() >= m_stopAfter) {
+    throw NashEquilibriumLimitReached();
+  }
+
+  return true;
+}
+
+//
+// Computes the equilibrium corresponding to a new CBFS, and outputs it.
+// Returns 'false' if the CBFS is the trivial (extraneous) solution.
+//
+template <class T> bool
+NashLcpStrategySolver<T>::OnEquilibrium(const StrategySupport &p_support,
+					BFS<T> &cbfs,
+					Solution &p_solution) const
+{
   MixedStrategyProfile<T> profile(p_support.NewMixedStrategyProfile<T>());
   int n1 = p_support.NumStrategies(1);
   int n2 = p_support.NumStrategies(2);
@@ -111,10 +138,6 @@ NashLcpStrategySolver<T>::OnBFS(const StrategySupport &p_support,
   this->m_onEquilibrium->Render(profile);
   p_solution.m_equilibria.push_back(profile);
 
-  if (m_stopAfter > 0 && p_solution.EquilibriumCount() >= m_stopAfter) {
-    throw NashEquilibriumLimitReached();
-  }
-
   return true;
 }
 
@@ -124,6 +147,8 @@ NashLcpStrategySolver<T>::OnBFS(const StrategySupport &p_support,
 // for the equilibria that have already been found.  
 // From each new accessible equilibrium, it follows
 // all possible paths, adding any new equilibria to the List.  
+// The tableau B is shared by the whole search, and is left at the
+// last CBFS reached.
 //
 template <class T> void 
 NashLcpStrategySolver<T>::AllLemke(const StrategySupport &p_support,
@@ -141,15 +166,284 @@ NashLcpStrategySolver<T>::AllLemke(const StrategySupport &p_support,
     return;
   }
   
+  // Rather than copying the tableau for each path, only its basis is
+  // kept, and the tableau is brought back to it before each path after
+  // the first.
+  Basis basis1(B.MinRow(), B.MaxRow(), B.MinCol(), B.MaxCol());
+  Basis basis2(B.MinRow(), B.MaxRow(), B.MinCol(), B.MaxCol());
+  B.GetBasis(basis1, basis2);
+  bool moved = false;
   for (int i = B.MinCol(); i <= B.MaxCol(); i++) {
     if (i != j)  {
-      LHTableau<T> Bcopy(B);
-      Bcopy.LemkePath(i);
-      AllLemke(p_support, i, Bcopy, p_solution, depth+1);
+      if (moved) {
+	B.SetBasis(basis1, basis2);
+      }
+      B.LemkePath(i);
+      moved = true;
+      AllLemke(p_support, i, B, p_solution, depth+1);
     }
   }
 }
 
+#ifdef HAVE_PTHREAD_H
+
+//
+// The parallel search follows the same paths as AllLemke, but each path
+// is a separate task: following the path which drops a given label from
+// a CBFS, known by its bases, that has been found at a given depth.
+// Each thread keeps a double-ended queue of tasks, working on the most
+// recent task it has created (so that a single thread follows the paths
+// in the same order as AllLemke), and taking the oldest task of another
+// thread when its own queue is empty.
+//
+// Each thread has a tableau of its own.  The queues, the set of CBFS
+// already found, and all objects of the game are only accessed while
+// holding the search's mutex; since a task follows a complete path,
+// the lock is held only briefly by comparison.
+//
+class LemkeThread {
+public:
+  pthread_t m_thread;
+
+  virtual ~LemkeThread() { }
+  virtual void Run(void) = 0;
+};
+
+extern "C" void *RunLemkeThread(void *p_thread)
+{
+  static_cast<LemkeThread *>(p_thread)->Run();
+  return 0;
+}
+
+template <class T> 
+class NashLcpStrategySolver<T>::Search {
+public:
+  class Task {
+  public:
+    // The bases of the CBFS from which the path starts
+    const std::pair<Basis, Basis> *m_bases;
+    // The label dropped, and the depth at which the CBFS was found
+    int m_label, m_depth;
+  };
+
+  class Thread : public LemkeThread {
+  public:
+    Search *m_search;
+    int m_index;
+    LHTableau<T> *m_tableau;
+
+    void Run(void) { m_search->Run(m_index, *m_tableau); }
+  };
+
+  const NashLcpStrategySolver<T> &m_solver;
+  const StrategySupport &m_support;
+  Solution &m_solution;
+
+  pthread_mutex_t m_mutex;
+  pthread_cond_t m_cond;
+  // The bases of all CBFS from which paths have been followed
+  std::deque<std::pair<Basis, Basis> > m_bases;
+  // The queue of tasks of each thread
+  std::vector<std::deque<Task> > m_queues;
+  // The basic labels of each CBFS found; two CBFS are the same if
+  // their bases are, as for BFS<T>::operator==
+  std::set<std::vector<int> > m_found;
+  // The number of tasks being worked on
+  int m_busy;
+  // Set when the search is to stop early
+  bool m_stop;
+  // The message of the first error encountered, if any
+  std::string m_error;
+
+  Search(const NashLcpStrategySolver<T> &p_solver,
+	 const StrategySupport &p_support, Solution &p_solution,
+	 int p_numThreads)
+    : m_solver(p_solver), m_support(p_support), m_solution(p_solution),
+      m_queues(p_numThreads), m_busy(0), m_stop(false)
+  {
+    pthread_mutex_init(&m_mutex, 0);
+    pthread_cond_init(&m_cond, 0);
+  }
+  ~Search()
+  {
+    pthread_cond_destroy(&m_cond);
+    pthread_mutex_destroy(&m_mutex);
+  }
+
+  void Expand(int p_thread, const Basis &, const Basis &,
+	      int p_dropped, int p_depth);
+  bool NextTask(int p_thread, Task &);
+  void Run(int p_thread, LHTableau<T> &);
+};
+
+//
+// Queues the paths from a new CBFS, found at p_depth by dropping
+// p_dropped, on the queue of the thread.  Called with the mutex held.
+//
+template <class T> void 
+NashLcpStrategySolver<T>::Search::Expand(int p_thread,
+					 const Basis &p_basis1,
+					 const Basis &p_basis2,
+					 int p_dropped, int p_depth)
+{
+  if (m_solver.m_maxDepth != 0 && p_depth + 1 > m_solver.m_maxDepth) {
+    return;
+  }
+  m_bases.push_back(std::pair<Basis, Basis>(p_basis1, p_basis2));
+  std::deque<Task> &queue = m_queues[p_thread];
+  Task task;
+  task.m_bases = &m_bases.back();
+  task.m_depth = p_depth;
+  // Queued in decreasing order, so that the lowest label is taken first
+  for (int i = p_basis1.MaxCol(); i >= p_basis1.MinCol(); i--) {
+    if (i != p_dropped) {
+      task.m_label = i;
+      queue.push_back(task);
+    }
+  }
+  pthread_cond_broadcast(&m_cond);
+}
+
+//
+// Takes the next task for the thread, waiting for one if other threads
+// are busy.  Returns false when there are no tasks left, or the search
+// is to stop.
+//
+template <class T> bool 
+NashLcpStrategySolver<T>::Search::NextTask(int p_thread, Task &p_task)
+{
+  pthread_mutex_lock(&m_mutex);
+  while (!m_stop) {
+    if (!m_queues[p_thread].empty()) {
+      p_task = m_queues[p_thread].back();
+      m_queues[p_thread].pop_back();
+      m_busy++;
+      pthread_mutex_unlock(&m_mutex);
+      return true;
+    }
+    for (size_t i = 0; i < m_queues.size(); i++) {
+      if (!m_queues[i].empty()) {
+	p_task = m_queues[i].front();
+	m_queues[i].pop_front();
+	m_busy++;
+	pthread_mutex_unlock(&m_mutex);
+	return true;
+      }
+    }
+    if (m_busy == 0) {
+      break;
+    }
+    pthread_cond_wait(&m_cond, &m_mutex);
+  }
+  pthread_cond_broadcast(&m_cond);
+  pthread_mutex_unlock(&m_mutex);
+  return false;
+}
+
+template <class T> void 
+NashLcpStrategySolver<T>::Search::Run(int p_thread, LHTableau<T> &p_tableau)
+{
+  Basis basis1(p_tableau.MinRow(), p_tableau.MaxRow(), 
+	       p_tableau.MinCol(), p_tableau.MaxCol());
+  Basis basis2(basis1);
+  Task task;
+  while (NextTask(p_thread, task)) {
+    BFS<T> cbfs;
+    std::vector<int> labels;
+    std::string error;
+    try {
+      p_tableau.SetBasis(task.m_bases->first, task.m_bases->second);
+      p_tableau.LemkePath(task.m_label);
+      cbfs = p_tableau.GetBFS();
+      for (int i = p_tableau.MinCol(); i <= p_tableau.MaxCol(); i++) {
+	if (p_tableau.Member(i)) {
+	  labels.push_back(i);
+	}
+      }
+      p_tableau.GetBasis(basis1, basis2);
+    }
+    catch (std::exception &e) {
+      error = e.what();
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    m_busy--;
+    if (!error.empty()) {
+      if (m_error.empty()) {
+	m_error = error;
+      }
+      m_stop = true;
+    }
+    else if (!m_stop && m_found.insert(labels).second &&
+	     m_solver.OnEquilibrium(m_support, cbfs, m_solution)) {
+      if (m_solver.m_stopAfter > 0 &&
+	  m_solution.EquilibriumCount() >= m_solver.m_stopAfter) {
+	m_stop = true;
+      }
+      else {
+	Expand(p_thread, basis1, basis2, task.m_label, task.m_depth + 1);
+      }
+    }
+    pthread_cond_broadcast(&m_cond);
+    pthread_mutex_unlock(&m_mutex);
+  }
+}
+
+//
+// Finds the same accessible equilibria as AllLemke, following the paths
+// in parallel.  The tableau B, at the extraneous solution, is used by
+// the first thread; the other threads have tableaus constructed from the
+// same matrices.  Equilibria are output as they are found, so their
+// order may differ from AllLemke's when more than one thread is used.
+//
+template <class T> void 
+NashLcpStrategySolver<T>::AllLemkeParallel(const StrategySupport &p_support,
+					   const Matrix<T> &A1, 
+					   const Matrix<T> &A2,
+					   const Vector<T> &b1, 
+					   const Vector<T> &b2,
+					   LHTableau<T> &B,
+					   Solution &p_solution) const
+{
+  Search search(*this, p_support, p_solution, m_numThreads);
+  Basis basis1(B.MinRow(), B.MaxRow(), B.MinCol(), B.MaxCol());
+  Basis basis2(basis1);
+  B.GetBasis(basis1, basis2);
+  search.Expand(0, basis1, basis2, 0, 0);
+
+  std::vector<typename Search::Thread> threads(m_numThreads);
+  for (int i = 0; i < m_numThreads; i++) {
+    threads[i].m_search = &search;
+    threads[i].m_index = i;
+    threads[i].m_tableau = (i == 0) ? &B : new LHTableau<T>(A1, A2, b1, b2);
+  }
+  // Threads which cannot be started are run in this thread instead
+  std::vector<bool> started(m_numThreads, false);
+  for (int i = 1; i < m_numThreads; i++) {
+    started[i] = (pthread_create(&threads[i].m_thread, 0,
+				 RunLemkeThread, &threads[i]) == 0);
+  }
+  for (int i = 0; i < m_numThreads; i++) {
+    if (!started[i]) {
+      threads[i].Run();
+    }
+  }
+  for (int i = 0; i < m_numThreads; i++) {
+    if (started[i]) {
+      pthread_join(threads[i].m_thread, 0);
+    }
+    if (i > 0) {
+      delete threads[i].m_tableau;
+    }
+  }
+
+  if (!search.m_error.empty()) {
+    throw std::runtime_error(search.m_error);
+  }
+}
+
+#endif  // HAVE_PTHREAD_H
+
 template <class T> List<MixedStrategyProfile<T> > 
 NashLcpStrategySolver<T>::Solve(const StrategySupport &p_support) const
 {
@@ -163,6 +457,12 @@ NashLcpStrategySolver<T>::Solve(const StrategySupport &p_support) const
     LHTableau<T> B(A1, A2, b1, b2);
 
     if (m_stopAfter != 1) {
+#ifdef HAVE_PTHREAD_H
+      if (m_numThreads > 1) {
+	AllLemkeParallel(p_support, A1, A2, b1, b2, B, solution);
+      }
+      else
+#endif  // HAVE_PTHREAD_H
       try {
 	AllLemke(p_support, 0, B, solution, 0);
       }
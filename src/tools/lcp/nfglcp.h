@@ -27,26 +27,39 @@
 
 using namespace Gambit;
 
+template <class T> class BFS;
 template <class T> class LHTableau;
 
 template <class T> class NashLcpStrategySolver : public NashStrategySolver<T> {
 public:
   NashLcpStrategySolver(int p_stopAfter, int p_maxDepth,
-		       shared_ptr<StrategyProfileRenderer<T> > p_onEquilibrium = 0)
+		       shared_ptr<StrategyProfileRenderer<T> > p_onEquilibrium = 0,
+		       int p_numThreads = 1)
     : NashStrategySolver<T>(p_onEquilibrium),
-      m_stopAfter(p_stopAfter), m_maxDepth(p_maxDepth) { }
+      m_stopAfter(p_stopAfter), m_maxDepth(p_maxDepth),
+      m_numThreads(p_numThreads) { }
   virtual ~NashLcpStrategySolver()  { }
 
   virtual List<MixedStrategyProfile<T> > Solve(const StrategySupport &) const;
 
 private:
-  int m_stopAfter, m_maxDepth;
+  int m_stopAfter, m_maxDepth, m_numThreads;
 
   class Solution;
 
   bool OnBFS(const StrategySupport &, LHTableau<T> &, Solution &) const;
+  bool OnEquilibrium(const StrategySupport &, BFS<T> &, 
+		     Solution &) const;
   void AllLemke(const StrategySupport &, int j, LHTableau<T> &, 
 		Solution &, int) const;
+#ifdef HAVE_PTHREAD_H
+  class Search;
+
+  void AllLemkeParallel(const StrategySupport &, 
+			const Matrix<T> &, const Matrix<T> &,
+			const Vector<T> &, const Vector<T> &,
+			LHTableau<T> &, Solution &) const;
+#endif  // HAVE_PTHREAD_H
 };
 
 
@@ -0,0 +1,193 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2014, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/lcp/sparsetab.h
+// Sparse matrices and Lemke tableau for sequence form problems
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef SPARSETAB_H
+#define SPARSETAB_H
+
+#include <vector>
+#include "liblinear/btableau.h"
+
+template <class T> class SparseMatrixBuilder;
+
+//
+// A matrix with rows and columns numbered from one, of which only the
+// nonzero entries are stored, column by column.  Matrices are filled
+// by a SparseMatrixBuilder.
+//
+template <class T> class SparseMatrix {
+  template <class U> friend class SparseMatrixBuilder;
+
+private:
+  int m_numRows, m_numCols;
+  /// The entries of column j are those from m_start[j-1] up to m_start[j]
+  std::vector<int> m_start;
+  std::vector<int> m_row;
+  std::vector<T> m_value;
+
+public:
+  SparseMatrix(void) : m_numRows(0), m_numCols(0), m_start(1, 0) { }
+
+  int NumRows(void) const { return m_numRows; }
+  int NumColumns(void) const { return m_numCols; }
+  /// Returns the number of entries stored
+  int NumEntries(void) const { return m_row.size(); }
+
+  /// The entries of a column are numbered from ColumnBegin() up to, but
+  /// not including, ColumnEnd(), in increasing order of row
+  int ColumnBegin(int p_col) const { return m_start[p_col - 1]; }
+  int ColumnEnd(int p_col) const { return m_start[p_col]; }
+  int GetRow(int p_entry) const { return m_row[p_entry]; }
+  const T &GetValue(int p_entry) const { return m_value[p_entry]; }
+};
+
+//
+// Collects the entries of a sparse matrix in any order.  Entries added
+// more than once at the same position are summed when the matrix is
+// built, so the builder may be used to accumulate sums of terms.
+//
+template <class T> class SparseMatrixBuilder {
+private:
+  struct Entry {
+    int m_row, m_col;
+    T m_value;
+
+    Entry(int p_row, int p_col, const T &p_value)
+      : m_row(p_row), m_col(p_col), m_value(p_value) { }
+    bool operator<(const Entry &p_other) const
+    { return (m_col < p_other.m_col ||
+	      (m_col == p_other.m_col && m_row < p_other.m_row)); }
+  };
+
+  int m_numRows, m_numCols;
+  std::vector<Entry> m_entries;
+
+public:
+  SparseMatrixBuilder(int p_numRows, int p_numCols)
+    : m_numRows(p_numRows), m_numCols(p_numCols) { }
+
+  /// Adds p_value to the entry in row p_row and column p_col
+  void Add(int p_row, int p_col, const T &p_value)
+  { m_entries.push_back(Entry(p_row, p_col, p_value)); }
+
+  /// Builds the matrix, converting each summed entry to the type of the
+  /// matrix, and omitting those which sum to zero
+  template <class U> void Build(SparseMatrix<U> &p_matrix);
+};
+
+//
+// A tableau for Lemke's algorithm on an LCP of the form w = q + M z + d z0,
+// in the layout of LTableau: there is a row for each equation, the labels
+// of the columns of M run from one, the covering vector d is label zero,
+// and label -i is the slack of row i.
+//
+// Rather than the whole tableau, only the basis is kept, with its inverse
+// in product form, as the pivots which build it up from the slack basis;
+// each pivot is stored as the nonzero entries of the column it brought
+// in.  The columns of M are read from a sparse matrix.  For the sequence
+// form, where M is mostly zero, the work of a pivot and the size of the
+// tableau thus grow with the number of nonzero entries rather than the
+// square of the number of rows.
+//
+template <class T> class SparseLTableau : public BaseTableau<T> {
+public:
+  class BadExitIndex : public Gambit::Exception  {
+  public:
+    virtual ~BadExitIndex() throw() { }
+    const char *what(void) const throw() { return "Bad Exit Index in SparseLTableau"; }
+  };
+
+  /// Creates the tableau at the slack basis.  The matrix is not copied,
+  /// and must outlive the tableau and its copies.
+  SparseLTableau(const SparseMatrix<T> &M, const Gambit::Vector<T> &d,
+		 const Gambit::Vector<T> &q);
+  virtual ~SparseLTableau() { }
+
+  /// @name Information
+  //@{
+  int MinRow(void) const { return 1; }
+  int MaxRow(void) const { return m_covering.Last(); }
+  int MinCol(void) const { return 0; }
+  int MaxCol(void) const { return m_matrix->NumColumns(); }
+  T Epsilon(void) const { return m_eps; }
+
+  bool Member(int i) const { return m_position[i] != 0; }
+  int Label(int i) const { return m_label[i]; }
+  int Find(int i) const { return m_position[i]; }
+  long NumPivots(void) const { return m_numPivots; }
+
+  void BasisVector(Gambit::Vector<T> &x) const { x = m_solution; }
+  //@}
+
+  /// @name Pivoting
+  //@{
+  /// Computes the column of label p_col in terms of the current basis
+  void SolveColumn(int p_col, Gambit::Vector<T> &p_out) const;
+  int CanPivot(int outrow, int col);
+  void Pivot(int outrow, int col);
+  /// Sets the entry of the covering vector in row p_row; the tableau
+  /// must be refactored before it is used
+  void SetCovering(int p_row, const T &p_value) { m_covering[p_row] = p_value; }
+  /// Factors the basis anew from the slack basis
+  void Refactor(void);
+  //@}
+
+  int SF_PivotIn(int i);
+  int SF_ExitIndex(int i);
+  int SF_LCPPath(int dup); // follow a path of ACBFS's from one CBFS to another
+
+private:
+  /// The pivot on row m_row, which brought in a column whose entries
+  /// in terms of the previous basis were m_pivot in row m_row, and
+  /// m_entries in the other rows
+  struct Eta {
+    int m_row;
+    T m_pivot;
+    std::vector<std::pair<int, T> > m_entries;
+  };
+
+  const SparseMatrix<T> *m_matrix;
+  Gambit::Vector<T> m_covering, m_const, m_solution;
+  /// The label in each row, and the row of each label, or zero
+  Gambit::Array<int> m_label, m_position;
+  std::vector<Eta> m_etas;
+  /// The number of entries in the etas, and the number after the last
+  /// refactoring
+  long m_numEntries, m_refactorEntries;
+  long m_numPivots;
+  T m_eps;
+  /// The rows which are candidates to leave the basis, in SF_ExitIndex
+  std::vector<int> m_candidates;
+
+  void GetColumn(int p_col, Gambit::Vector<T> &p_out) const;
+  void ApplyEta(const Eta &, Gambit::Vector<T> &) const;
+  /// Pivots the column p_in, which is p_col in terms of the current
+  /// basis, into row p_row
+  void AddEta(int p_row, int p_col, const Gambit::Vector<T> &p_in);
+  void SetSlackBasis(void);
+  /// Pivots label p_col, which is p_in in terms of the current basis,
+  /// into row p_row
+  void Pivot(int p_row, int p_col, const Gambit::Vector<T> &p_in);
+  /// Chooses the row to leave the basis when the column p_in enters
+  int SF_ExitIndex(const Gambit::Vector<T> &p_in);
+};
+
+#endif     // SPARSETAB_H
@@ -25,10 +25,14 @@
 
 #include <cstdlib>
 #include <unistd.h>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <vector>
 
 #include "libgambit/libgambit.h"
+#include "libgambit/multistart.h"
 #include "funcmin.h"
 
 extern int m_stopAfter;
@@ -41,6 +45,8 @@ extern std::string startFile;
 extern bool useRandom;
 extern int g_numDecimals;
 extern bool verbose;
+extern int g_numThreads;
+extern bool g_uniqueEquilibria;
 
 class EFLiapFunc : public gC1Function<double>  {
 private:
@@ -177,9 +183,85 @@ bool ReadProfile(std::istream &p_stream,
   return true;
 }
 
+//---------------------------------------------------------------------
+//                        class EFLiapWorker
+//---------------------------------------------------------------------
+
+class EFLiapWorker : public Gambit::MultiStartWorker {
+private:
+  Gambit::Game m_game;
+  const Gambit::List<Gambit::Vector<double> > *m_starts;
+
+public:
+  EFLiapWorker(const Gambit::Game &p_game,
+	       const Gambit::List<Gambit::Vector<double> > &p_starts)
+    : m_game(p_game), m_starts(&p_starts) { }
+  virtual ~EFLiapWorker() { }
+
+  void Run(int p_start, Gambit::MultiStartOutput &p_output);
+};
+
+void EFLiapWorker::Run(int p_start, Gambit::MultiStartOutput &p_output)
+{
+  static const double ALPHA = .00000001;
+
+  Gambit::MixedBehavProfile<double> p(m_game);
+  const Gambit::Vector<double> &start = (*m_starts)[p_start + 1];
+  for (int k = 1; k <= p.Length(); k++) {
+    p[k] = start[k];
+  }
+
+  if (verbose) {
+    PrintProfile(p_output.GetStream(), "start", p);
+  }
+
+  EFLiapFunc F(m_game, p);
+
+  // if starting vector not interior, perturb it towards centroid
+  int kk = 1;
+  for (; kk <= p.Length() && p[kk] > ALPHA; kk++);
+  if (kk <= p.Length()) {
+    Gambit::MixedBehavProfile<double> c(m_game);
+    for (int k = 1; k <= p.Length(); k++) {
+      p[k] = c[k]*ALPHA + p[k]*(1.0-ALPHA);
+    }
+  }
+
+  gConjugatePR minimizer(p.Length());
+  Gambit::Vector<double> gradient(p.Length()), dx(p.Length());
+  double fval;
+  minimizer.Set(F, p, fval, gradient, .01, .0001);
+
+  try {
+    for (int iter = 1; iter <= m_maxitsN; iter++) {
+      if (!minimizer.Iterate(F, p, fval, gradient, dx)) {
+	break;
+      }
+
+      if (sqrt(gradient.NormSquared()) < .001) {
+	std::ostringstream text;
+	PrintProfile(text, "NE", p);
+	std::vector<double> profile(p.Length());
+	for (int k = 1; k <= p.Length(); k++) {
+	  profile[k - 1] = p[k];
+	}
+	p_output.AddEquilibrium(profile, text.str());
+	break;
+      }
+    }
+
+    if (verbose && sqrt(gradient.NormSquared()) >= .001) {
+      PrintProfile(p_output.GetStream(), "end", p);
+    }
+  }
+  catch (gFuncMinException &) { }
+}
+
 void SolveExtensive(const Gambit::Game &p_game)
 {
-  Gambit::List<Gambit::MixedBehavProfile<double> > starts;
+  // Starting points are all chosen before any are run, so the sequence
+  // of random numbers, and the output, do not depend on the threads
+  Gambit::List<Gambit::Vector<double> > starts;
 
   if (startFile != "") {
     std::ifstream startPoints(startFile.c_str());
@@ -200,51 +282,21 @@ void SolveExtensive(const Gambit::Game &p_game)
     }
   }
 
-  static const double ALPHA = .00000001;
-
-  for (int i = 1; i <= starts.Length(); i++) {
-    Gambit::MixedBehavProfile<double> p(starts[i]);
-
-    if (verbose) {
-      PrintProfile(std::cout, "start", p);
+  // Each worker after the first solves on its own copy of the game
+  int numThreads = std::max(1, std::min(g_numThreads, starts.Length()));
+  std::vector<EFLiapWorker> workers;
+  for (int i = 0; i < numThreads; i++) {
+    Gambit::Game game = p_game;
+    if (i > 0) {
+      game = p_game->Copy();
     }
+    workers.push_back(EFLiapWorker(game, starts));
+  }
 
-    EFLiapFunc F(p_game, p);
-
-    // if starting vector not interior, perturb it towards centroid
-    int kk = 1;
-    for (; kk <= p.Length() && p[kk] > ALPHA; kk++);
-    if (kk <= p.Length()) {
-      Gambit::MixedBehavProfile<double> c(p_game);
-      for (int k = 1; k <= p.Length(); k++) {
-	p[k] = c[k]*ALPHA + p[k]*(1.0-ALPHA);
-      }
-    }
-
-    Gambit::Matrix<double> xi(p.Length(), p.Length());
-  
-    gConjugatePR minimizer(p.Length());
-    Gambit::Vector<double> gradient(p.Length()), dx(p.Length());
-    double fval;
-    minimizer.Set(F, p, fval, gradient, .01, .0001);
-
-    try {
-      for (int iter = 1; iter <= m_maxitsN; iter++) {
-	if (!minimizer.Iterate(F, p, fval, gradient, dx)) {
-	  break;
-	}
-
-	if (sqrt(gradient.NormSquared()) < .001) {
-	  PrintProfile(std::cout, "NE", p);
-	  break;
-	}
-      }
-
-      if (verbose && sqrt(gradient.NormSquared()) >= .001) {
-	PrintProfile(std::cout, "end", p);
-      }
-    }
-    catch (gFuncMinException &) { }
+  std::vector<Gambit::MultiStartWorker *> pointers;
+  for (int i = 0; i < numThreads; i++) {
+    pointers.push_back(&workers[i]);
   }
+  Gambit::MultiStartRunner runner(std::cout, g_uniqueEquilibria);
+  runner.Run(starts.Length(), pointers);
 }
-
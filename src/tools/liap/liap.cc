@@ -24,6 +24,8 @@
 #include <fstream>
 #include <cerrno>
 #include <cstdlib>
+#include <climits>
+#include <stdexcept>
 #include <unistd.h>
 #include <getopt.h>
 #include "libgambit/libgambit.h"
@@ -45,9 +47,11 @@ void PrintHelp(char *progname)
   std::cerr << "Options:\n";
   std::cerr << "  -d DECIMALS      print probabilities with DECIMALS digits\n";
   std::cerr << "  -h, --help       print this help message\n";
+  std::cerr << "  -j THREADS       number of threads to run starting points on (default 1)\n";
   std::cerr << "  -n COUNT         number of starting points to generate\n";
   std::cerr << "  -s FILE          file containing starting points\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
+  std::cerr << "  -u               report each distinct equilibrium only once\n";
   std::cerr << "  -V, --verbose    verbose mode (shows intermediate output)\n";
   std::cerr << "                   (default is to only show equilibria)\n";
   std::cerr << "  -v, --version    print version information\n";
@@ -67,6 +71,8 @@ std::string startFile = "";
 bool useRandom = false;
 int g_numDecimals = 6;
 bool verbose = false;
+int g_numThreads = 1;
+bool g_uniqueEquilibria = false;
 
 int main(int argc, char *argv[])
 {
@@ -81,7 +87,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:n:s:hqVvS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:n:s:hqVvSj:u", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -94,6 +100,19 @@ int main(int argc, char *argv[])
     case 's':
       startFile = optarg;
       break;
+    case 'j': {
+      char *end;
+      long threads = strtol(optarg, &end, 10);
+      if (end == optarg || *end != '\0' || threads < 1 || threads > INT_MAX) {
+	std::cerr << argv[0] << ": Number of threads must be a positive integer.\n";
+	PrintHelp(argv[0]);
+      }
+      g_numThreads = (int) threads;
+      break;
+    }
+    case 'u':
+      g_uniqueEquilibria = true;
+      break;
     case 'h':
       PrintHelp(argv[0]);
       break;
@@ -138,6 +157,7 @@ int main(int argc, char *argv[])
 
   try {
     Gambit::Game game = Gambit::ReadGame(*input_stream);
+    game->SetCompactPayoffs(true);
     
     if (!game->IsTree() || useStrategic) {
       SolveStrategic(game);
@@ -152,6 +172,10 @@ int main(int argc, char *argv[])
     if (verbose) std::cerr<<e.what()<<endl;
     return 1;
   }
+  catch (std::runtime_error &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
   catch (...) {
     std::cerr << "Error: An internal error occurred.\n";
     return 1;
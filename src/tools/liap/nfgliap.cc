@@ -22,10 +22,14 @@
 
 #include <cstdlib>
 #include <unistd.h>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <vector>
 
 #include "libgambit/libgambit.h"
+#include "libgambit/multistart.h"
 #include "funcmin.h"
 
 extern int m_stopAfter;
@@ -38,6 +42,8 @@ extern std::string startFile;
 extern bool useRandom;
 extern int g_numDecimals;
 extern bool verbose;
+extern int g_numThreads;
+extern bool g_uniqueEquilibria;
 
 //---------------------------------------------------------------------
 //                        class NFLiapFunc
@@ -48,12 +54,29 @@ private:
   mutable long _nevals;
   Gambit::Game _nfg;
   mutable Gambit::MixedStrategyProfile<double> _p;
+  /// The strategies in the support, indexed as the profile vector
+  Gambit::Array<Gambit::GameStrategy> _strategies;
+  /// The player of each entry of the profile vector
+  Gambit::Array<int> _players;
+
+  /// @name Values cached at the most recent point
+  //@{
+  /// The point, and whether the value and gradient there are current
+  mutable Gambit::Vector<double> _x;
+  mutable bool _haveValue, _haveGradient;
+  mutable double _value;
+  mutable Gambit::Vector<double> _gradient;
+  /// The profile with one player's probabilities replaced by regrets
+  mutable Gambit::MixedStrategyProfile<double> _regrets;
+  //@}
 
   double Value(const Gambit::Vector<double> &) const;
   bool Gradient(const Gambit::Vector<double> &, Gambit::Vector<double> &) const;
 
-  double LiapDerivValue(int, int, const Gambit::MixedStrategyProfile<double> &) const;
-    
+  /// Moves the profile to the point, invalidating the cache if it differs
+  void SetPoint(const Gambit::Vector<double> &) const;
+  /// Computes the (unprojected) gradient at the current point
+  void ComputeGradient(void) const;
 
 public:
   NFLiapFunc(const Gambit::Game &, const Gambit::MixedStrategyProfile<double> &);
@@ -64,43 +87,87 @@ public:
 
 NFLiapFunc::NFLiapFunc(const Gambit::Game &N,
 		       const Gambit::MixedStrategyProfile<double> &start)
-  : _nevals(0L), _nfg(N), _p(start)
-{ }
+  : _nevals(0L), _nfg(N), _p(start),
+    _strategies(start.MixedProfileLength()),
+    _players(start.MixedProfileLength()),
+    _x(start.MixedProfileLength()), _haveValue(false), _haveGradient(false),
+    _value(0.0), _gradient(start.MixedProfileLength()), _regrets(start)
+{
+  for (int i = 1, ii = 1; i <= _nfg->NumPlayers(); i++) {
+    for (int j = 1; j <= _p.GetSupport().NumStrategies(i); j++, ii++) {
+      _strategies[ii] = _p.GetSupport().GetStrategy(i, j);
+      _players[ii] = i;
+    }
+  }
+}
 
 NFLiapFunc::~NFLiapFunc()
 { }
 
-double NFLiapFunc::LiapDerivValue(int i1, int j1,
-				  const Gambit::MixedStrategyProfile<double> &p) const
+void NFLiapFunc::SetPoint(const Gambit::Vector<double> &v) const
 {
-  int i, j;
-  double x, x1, psum;
-  
-  x = 0.0;
-  for (i = 1; i <= _nfg->NumPlayers(); i++)  {
-    psum = 0.0;
-    for (j = 1; j <= p.GetSupport().NumStrategies(i); j++)  {
-      psum += p[p.GetSupport().GetStrategy(i,j)];
-      x1 = p.GetPayoff(p.GetSupport().GetStrategy(i, j)) - p.GetPayoff(i);
-      if (i1 == i) {
-	if (x1 > 0.0)
-	  x -= x1 * p.GetPayoffDeriv(i, p.GetSupport().GetStrategy(i1, j1));
+  if ((!_haveValue && !_haveGradient) || v != _x) {
+    _x = v;
+    ((Gambit::Vector<double> &) _p).operator=(v);
+    _haveValue = _haveGradient = false;
+  }
+}
+
+//
+// Writing r_ij for the regret u_i(s_ij, p_-i) - u_i(p) of player i's
+// strategy j, and R_i for the sum of the positive regrets of player i,
+// the derivative of the sum of squared positive regrets with respect to
+// strategy s of player k is
+//   -2 R_k u_k(s, p_-k) 
+//   + 2 sum_{i != k} (sum_j max(r_ij, 0) du_i(s_ij, p_-i)/ds - R_i du_i(p)/ds).
+// The inner sum over j is the derivative of player i's payoff at the
+// profile in which player i's probabilities are replaced by the positive
+// regrets, so all derivatives for player i are obtained from one sweep
+// of the payoff table at that profile.
+//
+void NFLiapFunc::ComputeGradient(void) const
+{
+  int n = _nfg->NumPlayers();
+  Gambit::Vector<double> regrets(_x.Length());
+  Gambit::Array<double> sums(n), psums(n);
+  for (int i = 1; i <= n; i++) {
+    sums[i] = psums[i] = 0.0;
+  }
+  for (int ii = 1; ii <= _x.Length(); ii++) {
+    int i = _players[ii];
+    double x1 = _p.GetPayoffDeriv(i, _strategies[ii]) - _p.GetPayoff(i);
+    regrets[ii] = (x1 > 0.0) ? x1 : 0.0;
+    sums[i] += regrets[ii];
+    psums[i] += _p[ii];
+  }
+
+  for (int ii = 1; ii <= _x.Length(); ii++) {
+    int i1 = _players[ii];
+    _gradient[ii] = (-sums[i1] * _p.GetPayoffDeriv(i1, _strategies[ii]) +
+		     100.0 * (psums[i1] - 1.0));
+    if (_p[ii] < 0.0) {
+      _gradient[ii] += _p[ii];
+    }
+  }
+
+  for (int i = 1; i <= n; i++) {
+    if (sums[i] == 0.0) continue;
+    ((Gambit::Vector<double> &) _regrets).operator=(_p);
+    for (int ii = 1; ii <= _x.Length(); ii++) {
+      if (_players[ii] == i) {
+	_regrets[ii] = regrets[ii];
       }
-      else {
-	if (x1> 0.0)
-	  x += x1 * (p.GetPayoffDeriv(i, 
-				      p.GetSupport().GetStrategy(i, j),
-				      p.GetSupport().GetStrategy(i1, j1)) - 
-		     p.GetPayoffDeriv(i,
-				      p.GetSupport().GetStrategy(i1, j1)));
+    }
+    for (int ii = 1; ii <= _x.Length(); ii++) {
+      if (_players[ii] != i) {
+	_gradient[ii] += (_regrets.GetPayoffDeriv(i, _strategies[ii]) -
+			  sums[i] * _p.GetPayoffDeriv(i, _strategies[ii]));
       }
     }
-    if (i == i1)  x += 100.0 * (psum - 1.0);
-  }
-  if (p[p.GetSupport().GetStrategy(i1, j1)] < 0.0) {
-    x += p[p.GetSupport().GetStrategy(i1, j1)];
   }
-  return 2.0 * x;
+
+  _gradient *= 2.0;
+  _haveGradient = true;
 }
 
 //
@@ -128,15 +195,11 @@ static void Project(Gambit::Vector<double> &x, const Gambit::Array<int> &lengths
 
 bool NFLiapFunc::Gradient(const Gambit::Vector<double> &v, Gambit::Vector<double> &d) const
 {
-  ((Gambit::Vector<double> &) _p).operator=(v);
-  int i1, j1, ii;
-  
-  for (i1 = 1, ii = 1; i1 <= _nfg->NumPlayers(); i1++) {
-    for (j1 = 1; j1 <= _p.GetSupport().NumStrategies(i1); j1++) {
-      d[ii++] = LiapDerivValue(i1, j1, _p);
-    }
+  SetPoint(v);
+  if (!_haveGradient) {
+    ComputeGradient();
   }
-
+  d = _gradient;
   Project(d, _p.GetSupport().NumStrategies());
   return true;
 }
@@ -145,8 +208,12 @@ double NFLiapFunc::Value(const Gambit::Vector<double> &v) const
 {
   _nevals++;
 
-  ((Gambit::Vector<double> &) _p).operator=(v);
-  return _p.GetLiapValue();
+  SetPoint(v);
+  if (!_haveValue) {
+    _value = _p.GetLiapValue();
+    _haveValue = true;
+  }
+  return _value;
 }
 
 static void PickRandomProfile(Gambit::MixedStrategyProfile<double> &p)
@@ -202,11 +269,87 @@ bool ReadProfile(std::istream &p_stream,
   return true;
 }
 
-extern std::string startFile;
+//---------------------------------------------------------------------
+//                        class NFLiapWorker
+//---------------------------------------------------------------------
+
+class NFLiapWorker : public Gambit::MultiStartWorker {
+private:
+  Gambit::Game m_game;
+  const Gambit::List<Gambit::Vector<double> > *m_starts;
+
+public:
+  NFLiapWorker(const Gambit::Game &p_game,
+	       const Gambit::List<Gambit::Vector<double> > &p_starts)
+    : m_game(p_game), m_starts(&p_starts) { }
+  virtual ~NFLiapWorker() { }
+
+  void Run(int p_start, Gambit::MultiStartOutput &p_output);
+};
+
+void NFLiapWorker::Run(int p_start, Gambit::MultiStartOutput &p_output)
+{
+  static const double ALPHA = .00000001;
+
+  Gambit::MixedStrategyProfile<double> p(m_game->NewMixedStrategyProfile(0.0));
+  const Gambit::Vector<double> &start = (*m_starts)[p_start + 1];
+  for (int k = 1; k <= p.MixedProfileLength(); k++) {
+    p[k] = start[k];
+  }
+
+  if (verbose) {
+    PrintProfile(p_output.GetStream(), "start", p);
+  }
+
+  NFLiapFunc F(p.GetGame(), p);
+
+  // if starting vector not interior, perturb it towards centroid
+  int kk;
+  for (kk = 1; kk <= p.MixedProfileLength() && p[kk] > ALPHA; kk++);
+  if (kk <= p.MixedProfileLength()) {
+    Gambit::MixedStrategyProfile<double> centroid(p.GetSupport().NewMixedStrategyProfile<double>());
+    for (int k = 1; k <= p.MixedProfileLength(); k++) {
+      p[k] = centroid[k] * ALPHA + p[k] * (1.0-ALPHA);
+    }
+  }
+
+  gConjugatePR minimizer(p.MixedProfileLength());
+  Gambit::Vector<double> gradient(p.MixedProfileLength()), dx(p.MixedProfileLength());
+  double fval;
+  minimizer.Set(F, (const Gambit::Vector<double> &) p,
+		fval, gradient, .01, .0001);
+
+  try {
+    for (int iter = 1; iter <= m_maxitsN; iter++) {
+      if (!minimizer.Iterate(F, (Gambit::Vector<double> &) p, 
+			     fval, gradient, dx)) {
+	break;
+      }
+
+      if (sqrt(gradient.NormSquared()) < .001) {
+	std::ostringstream text;
+	PrintProfile(text, "NE", p);
+	std::vector<double> profile(p.MixedProfileLength());
+	for (int k = 1; k <= p.MixedProfileLength(); k++) {
+	  profile[k - 1] = p[k];
+	}
+	p_output.AddEquilibrium(profile, text.str());
+	break;
+      }
+    }
+
+    if (verbose && sqrt(gradient.NormSquared()) >= .001) {
+      PrintProfile(p_output.GetStream(), "end", p);
+    }
+  }
+  catch (gFuncMinException &) { }
+}
 
 void SolveStrategic(const Gambit::Game &p_game)
 {
-  Gambit::List<Gambit::MixedStrategyProfile<double> > starts;
+  // Starting points are all chosen before any are run, so the sequence
+  // of random numbers, and the output, do not depend on the threads
+  Gambit::List<Gambit::Vector<double> > starts;
 
   if (startFile != "") {
     std::ifstream startPoints(startFile.c_str());
@@ -214,7 +357,7 @@ void SolveStrategic(const Gambit::Game &p_game)
     while (!startPoints.eof() && !startPoints.bad()) {
       Gambit::MixedStrategyProfile<double> start(p_game->NewMixedStrategyProfile(0.0));
       if (ReadProfile(startPoints, start)) {
-	starts.Append(start);
+	starts.Append((const Gambit::Vector<double> &) start);
       }
     }
   }
@@ -223,58 +366,25 @@ void SolveStrategic(const Gambit::Game &p_game)
     for (int i = 1; i <= m_numTries; i++) {
       Gambit::MixedStrategyProfile<double> start(p_game->NewMixedStrategyProfile(0.0));
       PickRandomProfile(start);
-      starts.Append(start);
+      starts.Append((const Gambit::Vector<double> &) start);
     }
   }
 
-  static const double ALPHA = .00000001;
-
-  for (int i = 1; i <= starts.Length(); i++) {
-    Gambit::MixedStrategyProfile<double> p(starts[i]);
-
-    if (verbose) {
-      PrintProfile(std::cout, "start", p);
+  // Each worker after the first solves on its own copy of the game
+  int numThreads = std::max(1, std::min(g_numThreads, starts.Length()));
+  std::vector<NFLiapWorker> workers;
+  for (int i = 0; i < numThreads; i++) {
+    Gambit::Game game = p_game;
+    if (i > 0) {
+      game = p_game->Copy();
     }
+    workers.push_back(NFLiapWorker(game, starts));
+  }
 
-    NFLiapFunc F(p.GetGame(), p);
-
-    // if starting vector not interior, perturb it towards centroid
-    int kk;
-    for (kk = 1; kk <= p.MixedProfileLength() && p[kk] > ALPHA; kk++);
-    if (kk <= p.MixedProfileLength()) {
-      Gambit::MixedStrategyProfile<double> centroid(p.GetSupport().NewMixedStrategyProfile<double>());
-      for (int k = 1; k <= p.MixedProfileLength(); k++) {
-	p[k] = centroid[k] * ALPHA + p[k] * (1.0-ALPHA);
-      }
-    }
-
-    gConjugatePR minimizer(p.MixedProfileLength());
-    Gambit::Vector<double> gradient(p.MixedProfileLength()), dx(p.MixedProfileLength());
-    double fval;
-    minimizer.Set(F, (const Gambit::Vector<double> &) p,
-		  fval, gradient, .01, .0001);
-
-    try {
-      for (int iter = 1; iter <= m_maxitsN; iter++) {
-	if (!minimizer.Iterate(F, (Gambit::Vector<double> &) p, 
-			       fval, gradient, dx)) {
-	  break;
-	}
-
-	if (sqrt(gradient.NormSquared()) < .001) {
-	  PrintProfile(std::cout, "NE", p);
-	  break;
-	}
-      }
-
-      if (verbose && sqrt(gradient.NormSquared()) >= .001) {
-	PrintProfile(std::cout, "end", p);
-      }
-    }
-    catch (gFuncMinException &) { }
+  std::vector<Gambit::MultiStartWorker *> pointers;
+  for (int i = 0; i < numThreads; i++) {
+    pointers.push_back(&workers[i]);
   }
+  Gambit::MultiStartRunner runner(std::cout, g_uniqueEquilibria);
+  runner.Run(starts.Length(), pointers);
 }
-
-
-
-
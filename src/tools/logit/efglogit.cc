@@ -23,6 +23,9 @@
 
 #include <cmath>
 #include <iostream>
+#include <map>
+#include <set>
+#include <vector>
 #include <libgambit/libgambit.h>
 #include "logbehav.imp"
 
@@ -46,6 +49,10 @@ public:
   virtual void Gradient(const LogBehavProfile<double> &p_point, 
 			double p_lambda,
 			Vector<double> &p_gradient) = 0;
+  // Append the nonzero entries of the gradient as a row of the Jacobian
+  virtual void SparseGradient(const LogBehavProfile<double> &p_point,
+			      double p_lambda,
+			      SparseJacobian &p_jacobian) = 0;
 };
 
 //
@@ -55,12 +62,12 @@ public:
 class SumToOneEquation : public Equation {
 private:
   Game m_game;
-  int m_pl, m_iset;
+  int m_pl, m_iset, m_offset;
   GameInfoset m_infoset;
 
 public:
-  SumToOneEquation(Game p_game, int p_player, int p_infoset)
-    : m_game(p_game), m_pl(p_player), m_iset(p_infoset),
+  SumToOneEquation(Game p_game, int p_player, int p_infoset, int p_offset)
+    : m_game(p_game), m_pl(p_player), m_iset(p_infoset), m_offset(p_offset),
       m_infoset(p_game->GetPlayer(p_player)->GetInfoset(p_infoset))
   { }
 
@@ -68,6 +75,8 @@ public:
 	       double p_lambda);
   void Gradient(const LogBehavProfile<double> &p_profile, double p_lambda,
 		Vector<double> &p_gradient);
+  void SparseGradient(const LogBehavProfile<double> &p_profile,
+		      double p_lambda, SparseJacobian &p_jacobian);
 };
 
 
@@ -107,6 +116,17 @@ void SumToOneEquation::Gradient(const LogBehavProfile<double> &p_profile,
   // Derivative wrt lambda is zero
   p_gradient[i] = 0.0;
 }
+
+void SumToOneEquation::SparseGradient(const LogBehavProfile<double> &p_profile,
+				      double p_lambda,
+				      SparseJacobian &p_jacobian)
+{
+  for (int act = 1; act <= m_infoset->NumActions(); act++) {
+    p_jacobian.AddEntry(m_offset + act - 1, 
+			p_profile.GetProb(m_pl, m_iset, act));
+  }
+  p_jacobian.EndRow();
+}
 			       
 
 //
@@ -119,17 +139,24 @@ private:
   Game m_game;
   int m_pl, m_iset, m_act;
   GameInfoset m_infoset;
+  const Array<Array<int> > &m_offsets;
+  const Array<GameInfoset> &m_related;
 
 public:
-  RatioEquation(Game p_game, int p_player, int p_infoset, int p_action)
+  RatioEquation(Game p_game, int p_player, int p_infoset, int p_action,
+		const Array<Array<int> > &p_offsets,
+		const Array<GameInfoset> &p_related)
     : m_game(p_game), m_pl(p_player), m_iset(p_infoset), m_act(p_action),
-      m_infoset(p_game->GetPlayer(p_player)->GetInfoset(p_infoset))
+      m_infoset(p_game->GetPlayer(p_player)->GetInfoset(p_infoset)),
+      m_offsets(p_offsets), m_related(p_related)
   { }
 
   double Value(const LogBehavProfile<double> &p_profile, 
 	       double p_lambda);
   void Gradient(const LogBehavProfile<double> &p_profile, double p_lambda,
 		Vector<double> &p_gradient);
+  void SparseGradient(const LogBehavProfile<double> &p_profile,
+		      double p_lambda, SparseJacobian &p_jacobian);
 };
 
 
@@ -180,6 +207,71 @@ void RatioEquation::Gradient(const LogBehavProfile<double> &p_profile,
 		   p_profile.GetPayoff(m_infoset->GetAction(m_act)));
 }
 
+void RatioEquation::SparseGradient(const LogBehavProfile<double> &p_profile,
+				   double p_lambda,
+				   SparseJacobian &p_jacobian)
+{
+  int offset = m_offsets[m_pl][m_iset];
+  p_jacobian.AddEntry(offset, -1.0);
+  p_jacobian.AddEntry(offset + m_act - 1, 1.0);
+
+  for (int i = 1; i <= m_related.Length(); i++) {
+    GameInfoset infoset = m_related[i];
+    int first = m_offsets[infoset->GetPlayer()->GetNumber()][infoset->GetNumber()];
+    for (int act = 1; act <= infoset->NumActions(); act++) {
+      p_jacobian.AddEntry(first + act - 1,
+			  -p_lambda * 
+			  (p_profile.DiffActionValue(m_infoset->GetAction(m_act),
+						     infoset->GetAction(act)) -
+			   p_profile.DiffActionValue(m_infoset->GetAction(1),
+						     infoset->GetAction(act))));
+    }
+  }
+
+  p_jacobian.AddEntry(p_jacobian.NumColumns(),
+		      p_profile.GetPayoff(m_infoset->GetAction(1)) -
+		      p_profile.GetPayoff(m_infoset->GetAction(m_act)));
+  p_jacobian.EndRow();
+}
+
+//
+// Records, for each pair of player information sets at which one has a
+// member preceding a member of the other, that each is related to the other.
+// p_path holds the indices of the information sets on the path to the node.
+//
+static void
+FindRelatedInfosets(const GameNode &p_node,
+		    const std::map<GameInfosetRep *, int> &p_index,
+		    std::vector<int> &p_path,
+		    std::vector<std::set<int> > &p_related)
+{
+  if (p_node->NumChildren() == 0) {
+    return;
+  }
+
+  GameInfoset infoset = p_node->GetInfoset();
+  bool isPlayer = !infoset->GetPlayer()->IsChance();
+  if (isPlayer) {
+    int index = p_index.find(infoset)->second;
+    for (std::vector<int>::const_iterator i = p_path.begin();
+	 i != p_path.end(); ++i) {
+      if (*i != index) {
+	p_related[index].insert(*i);
+	p_related[*i].insert(index);
+      }
+    }
+    p_path.push_back(index);
+  }
+
+  for (int i = 1; i <= p_node->NumChildren(); i++) {
+    FindRelatedInfosets(p_node->GetChild(i), p_index, p_path, p_related);
+  }
+
+  if (isPlayer) {
+    p_path.pop_back();
+  }
+}
+
 
 //------------------------------------------------------------------------------
 //                        AgentQREPathTracer: Lifecycle
@@ -189,12 +281,42 @@ AgentQREPathTracer::AgentQREPathTracer(const MixedBehavProfile<double> &p_start)
   : m_start(p_start), m_fullGraph(true), m_decimals(6)
 { 
   SetTargetParam(-1.0);
-  for (int pl = 1; pl <= p_start.GetGame()->NumPlayers(); pl++) {
-    GamePlayer player = p_start.GetGame()->GetPlayer(pl);
+  Game game = p_start.GetGame();
+
+  // Number the information sets, and locate their actions in the profile
+  Array<GameInfoset> infosets;
+  std::map<GameInfosetRep *, int> index;
+  for (int pl = 1, offset = 1; pl <= game->NumPlayers(); pl++) {
+    GamePlayer player = game->GetPlayer(pl);
+    m_offsets.Append(Array<int>(player->NumInfosets()));
     for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-      m_equations.Append(new SumToOneEquation(p_start.GetGame(), pl, iset));
+      GameInfoset infoset = player->GetInfoset(iset);
+      infosets.Append(infoset);
+      index[infoset] = infosets.Length();
+      m_offsets[pl][iset] = offset;
+      offset += infoset->NumActions();
+    }
+  }
+
+  std::vector<std::set<int> > related(infosets.Length() + 1);
+  std::vector<int> path;
+  FindRelatedInfosets(game->GetRoot(), index, path, related);
+  for (int i = 1; i <= infosets.Length(); i++) {
+    m_related.Append(Array<GameInfoset>());
+    for (std::set<int>::const_iterator j = related[i].begin();
+	 j != related[i].end(); ++j) {
+      m_related[i].Append(infosets[*j]);
+    }
+  }
+
+  for (int pl = 1, i = 1; pl <= game->NumPlayers(); pl++) {
+    GamePlayer player = game->GetPlayer(pl);
+    for (int iset = 1; iset <= player->NumInfosets(); iset++, i++) {
+      m_equations.Append(new SumToOneEquation(game, pl, iset,
+					      m_offsets[pl][iset]));
       for (int act = 2; act <= player->GetInfoset(iset)->NumActions(); act++) {
-	m_equations.Append(new RatioEquation(p_start.GetGame(), pl, iset, act));
+	m_equations.Append(new RatioEquation(game, pl, iset, act,
+					     m_offsets, m_related[i]));
       }
     }
   }
@@ -276,6 +398,24 @@ AgentQREPathTracer::GetJacobian(const Vector<double> &p_point,
 }
 
 
+void
+AgentQREPathTracer::GetSparseJacobian(const Vector<double> &p_point, 
+				      SparseJacobian &p_jacobian)
+{
+  Game game = m_start.GetGame();
+  LogBehavProfile<double> profile(game);
+  for (int i = 1; i <= profile.Length(); i++) {
+    profile.SetLogProb(i, p_point[i]);
+  }
+  double lambda = p_point[p_point.Length()];
+
+  p_jacobian.Clear(p_point.Length());
+  for (int i = 1; i <= m_equations.Length(); i++) {
+    m_equations[i]->SparseGradient(profile, lambda, p_jacobian);
+  }
+}
+
+
 //----------------------------------------------------------------------------
 //                 AgentQREPathTracer: Outputting profiles
 //----------------------------------------------------------------------------
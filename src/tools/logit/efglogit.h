@@ -52,10 +52,20 @@ protected:
   virtual void GetLHS(const Vector<double> &p_point, Vector<double> &p_lhs);
   // Compute the Jacobian matrix at the specified point.
   virtual void GetJacobian(const Vector<double> &p_point, Matrix<double> &p_matrix);
+  // Compute the Jacobian at the specified point in sparse form.
+  virtual void GetSparseJacobian(const Vector<double> &p_point,
+				 SparseJacobian &p_jacobian);
 
 private:
   MixedBehavProfile<double> m_start;
   Array<Equation *> m_equations;
+  // Index in the profile of the first action at each information set,
+  // by player and information set
+  Array<Array<int> > m_offsets;
+  // For each information set, in order by player, the information sets
+  // preceding or following any of its members; the payoffs to its actions
+  // depend only on the probabilities of actions at these
+  Array<Array<GameInfoset> > m_related;
   bool m_fullGraph;
   int m_decimals;
 
@@ -58,6 +58,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -e               print only the terminal equilibrium\n";
   std::cerr << "                   (default is to print the entire branch)\n";
+  std::cerr << "  -z               use sparse linear algebra for extensive games\n";
+  std::cerr << "                   (for trees with many actions)\n";
   std::cerr << "  -v, --version    print version information\n";
   exit(1);
 }
@@ -95,7 +97,7 @@ int main(int argc, char *argv[])
   double maxDecel = 1.1;
   double hStart = 0.03;
   double targetLambda = -1.0;
-  bool fullGraph = true;
+  bool fullGraph = true, useSparse = false;
   int decimals = 6;
 
   int long_opt_index = 0;
@@ -105,7 +107,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:s:a:m:vqehSL:p:l:", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:s:a:m:vqehSzL:p:l:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -133,6 +135,9 @@ int main(int argc, char *argv[])
     case 'S':
       useStrategic = true;
       break;
+    case 'z':
+      useSparse = true;
+      break;
     case 'L':
       mleFile = optarg;
       break;
@@ -175,6 +180,7 @@ int main(int argc, char *argv[])
   try {
     Gambit::Array<double> frequencies;
     Gambit::Game game = Gambit::ReadGame(*input_stream);
+    game->SetCompactPayoffs(true);
 
     if (mleFile != "" && (!game->IsTree() || useStrategic)) {
       frequencies = Gambit::Array<double>(game->MixedProfileLength());
@@ -229,6 +235,7 @@ int main(int argc, char *argv[])
       tracer.SetFullGraph(fullGraph);
       tracer.SetTargetParam(targetLambda);
       tracer.SetDecimals(decimals);
+      tracer.SetSparse(useSparse);
       tracer.TraceAgentPath(start, 0.0, maxLambda, 1.0);
     }
     return 0;
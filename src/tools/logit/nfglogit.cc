@@ -85,15 +85,16 @@ void
 StrategicQREPathTracer::GetLHS(const Vector<double> &p_point, Vector<double> &p_lhs)
 {
   const StrategySupport &support = m_start.GetSupport();
-  MixedStrategyProfile<double> profile(support.NewMixedStrategyProfile<double>()), logprofile(support.NewMixedStrategyProfile<double>());
+  MixedStrategyProfile<double> &profile = m_profile;
   for (int i = 1; i <= profile.MixedProfileLength(); i++) {
     profile[i] = exp(p_point[i]);
-    logprofile[i] = p_point[i];
   }
   double lambda = p_point[p_point.Length()];
   p_lhs = 0.0;
   for (int rowno = 0, pl = 1; pl <= support.NumPlayers(); pl++) {
     StrategySupportPlayer player = support.GetPlayer(pl);
+    // Index of the player's first strategy in the point
+    int first = rowno + 1;
     for (int st = 1; st <= player->NumStrategies(); st++) {
       rowno++;
       if (st == 1) {
@@ -105,8 +106,7 @@ StrategicQREPathTracer::GetLHS(const Vector<double> &p_point, Vector<double> &p_
       }
       else {
 	// This is a ratio equation
-	p_lhs[rowno] = (logprofile[player->GetStrategy(st)] - 
-			logprofile[player->GetStrategy(1)] -
+	p_lhs[rowno] = (p_point[rowno] - p_point[first] -
 			lambda * (profile.GetPayoff(player->GetStrategy(st)) -
 				  profile.GetPayoff(player->GetStrategy(1))));
 
@@ -120,10 +120,9 @@ StrategicQREPathTracer::GetJacobian(const Vector<double> &p_point,
 				    Matrix<double> &p_matrix)
 {
   const StrategySupport &support = m_start.GetSupport();
-  MixedStrategyProfile<double> profile(support.NewMixedStrategyProfile<double>()), logprofile(support.NewMixedStrategyProfile<double>());
+  MixedStrategyProfile<double> &profile = m_profile;
   for (int i = 1; i <= profile.MixedProfileLength(); i++) {
     profile[i] = exp(p_point[i]);
-    logprofile[i] = p_point[i];
   }
   double lambda = p_point[p_point.Length()];
 
@@ -131,6 +130,9 @@ StrategicQREPathTracer::GetJacobian(const Vector<double> &p_point,
 
   for (int rowno = 0, i = 1; i <= support.NumPlayers(); i++) {
     StrategySupportPlayer player = support.GetPlayer(i);
+    // Second derivatives of player i's payoff with respect to each of
+    // the player's strategies and each strategy in the profile
+    profile.GetPayoffDerivs(i, m_payoffDerivs);
     for (int j = 1; j <= player->NumStrategies(); j++) {
       rowno++;
       if (j == 1) {
@@ -165,12 +167,7 @@ StrategicQREPathTracer::GetJacobian(const Vector<double> &p_point,
 	    else {
 	      p_matrix(colno, rowno) =
 		-lambda * profile[player2->GetStrategy(m)] *
-		(profile.GetPayoffDeriv(i, 
-					player->GetStrategy(j),
-					player2->GetStrategy(m)) -
-		 profile.GetPayoffDeriv(i, 
-					player->GetStrategy(1),
-					player2->GetStrategy(m)));
+		(m_payoffDerivs(j, colno) - m_payoffDerivs(1, colno));
 	    }
 	  }
 	}
@@ -29,7 +29,7 @@
 class StrategicQREPathTracer : public PathTracer {
 public:
   StrategicQREPathTracer(const MixedStrategyProfile<double> &p_start) 
-    : m_start(p_start), m_fullGraph(true), m_decimals(6)
+    : m_start(p_start), m_profile(p_start), m_fullGraph(true), m_decimals(6)
     { SetTargetParam(-1.0); }
   virtual ~StrategicQREPathTracer() { }
 
@@ -67,6 +67,11 @@ private:
   double LogLike(const Array<double> &p_point);
 
   MixedStrategyProfile<double> m_start;
+  // Workspace for evaluating the equations and Jacobian; reusing the
+  // profile lets a Jacobian at the point of the last LHS evaluation
+  // use the payoffs already computed there
+  MixedStrategyProfile<double> m_profile;
+  Matrix<double> m_payoffDerivs;
   bool m_fullGraph;
   Array<double> m_frequencies;
   int m_decimals;
@@ -21,89 +21,501 @@
 //
 
 #include <cmath>
-#include <algorithm>   // for std::max
+#include <algorithm>   // for std::max, std::min, std::fill
 #include <iostream>
 
 #include <libgambit/libgambit.h>
-#include <libgambit/sqmatrix.h>
 using namespace Gambit;
 
 #include "path.h"
 
 //----------------------------------------------------------------------------
-//                       PathTracer: Auxiliary functions
+//                  PathQR: Factorization of the Jacobian
 //----------------------------------------------------------------------------
 
 inline double sqr(double x) { return x*x; }
 
-static void Givens(Matrix<double> &b, Matrix<double> &q,
-		   double &c1, double &c2, int l1, int l2, int l3)
+void PathQR::Resize(int p_rows, int p_cols)
 {
-  if (fabs(c1) + fabs(c2) == 0.0) {
+  if (p_rows == m_rows && p_cols == m_cols) {
+    return;
+  }
+  m_rows = p_rows;
+  m_cols = p_cols;
+  m_r.resize(m_rows * m_cols);
+  m_q.resize(m_rows * m_rows);
+  m_w.resize(m_cols);
+  m_z.resize(m_rows);
+}
+
+void PathQR::Factor(const Matrix<double> &p_matrix)
+{
+  Resize(p_matrix.NumRows(), p_matrix.NumColumns());
+  const int rows = m_rows, cols = m_cols;
+
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      R(i, j) = p_matrix(i + 1, j + 1);
+    }
+  }
+  std::fill(m_q.begin(), m_q.end(), 0.0);
+  for (int i = 0; i < rows; i++) {
+    Q(i, i) = 1.0;
+  }
+
+  // Rotations are used rather than reflections because they remain
+  // accurate when the rows of B differ widely in scale, as they do for
+  // large lambda.  A rotation by a zero entry is the identity unless it
+  // changes the sign of the diagonal, and is skipped.
+  for (int m = 0; m < cols; m++) {
+    for (int k = m + 1; k < rows; k++) {
+      if (R(k, m) != 0.0 || R(m, m) < 0.0) {
+	Rotate(m, k, R(m, m), R(k, m), m + 1);
+      }
+    }
+  }
+}
+
+//
+// Applies a Givens rotation to rows p_row1 and p_row2 of q, and of R
+// from column p_col onwards, chosen to zero out p_c2 against p_c1.
+//
+void PathQR::Rotate(int p_row1, int p_row2, double &p_c1, double &p_c2,
+		    int p_col)
+{
+  if (fabs(p_c1) + fabs(p_c2) == 0.0) {
     return;
   }
 
   double sn;
-  if (fabs(c2) >= fabs(c1)) {
-    sn = sqrt(1.0 + sqr(c1/c2)) * fabs(c2);
+  if (fabs(p_c2) >= fabs(p_c1)) {
+    sn = sqrt(1.0 + sqr(p_c1/p_c2)) * fabs(p_c2);
   }
   else {
-    sn = sqrt(1.0 + sqr(c2/c1)) * fabs(c1);
+    sn = sqrt(1.0 + sqr(p_c2/p_c1)) * fabs(p_c1);
+  }
+  double s1 = p_c1/sn;
+  double s2 = p_c2/sn;
+
+  double *q1 = &Q(p_row1, 0), *q2 = &Q(p_row2, 0);
+  for (int k = 0; k < m_rows; k++) {
+    double sv1 = q1[k];
+    double sv2 = q2[k];
+    q1[k] = s1 * sv1 + s2 * sv2;
+    q2[k] = -s2 * sv1 + s1 * sv2;
+  }
+
+  double *r1 = &m_r[p_row1 * m_cols], *r2 = &m_r[p_row2 * m_cols];
+  for (int k = p_col; k < m_cols; k++) {
+    double sv1 = r1[k];
+    double sv2 = r2[k];
+    r1[k] = s1 * sv1 + s2 * sv2;
+    r2[k] = -s2 * sv1 + s1 * sv2;
+  }
+
+  p_c1 = sn;
+  p_c2 = 0.0;
+}
+
+//
+// With s the step and r = H(new) - H(old) - J s, the Jacobian J = B^T is
+// replaced by J + r s^T / (s^T s), so q B becomes R + (q s) v^T with
+// v = r / (s^T s).  The vector q s is rotated onto the first coordinate,
+// leaving R upper Hessenberg, the rank-one term is added to the first row,
+// and R is returned to triangular form, all by Givens rotations.
+//
+void PathQR::Update(const Vector<double> &p_step,
+		    const Vector<double> &p_oldLHS,
+		    const Vector<double> &p_newLHS)
+{
+  const int rows = m_rows, cols = m_cols;
+
+  double ss = 0.0;
+  for (int k = 0; k < rows; k++) {
+    ss += sqr(p_step[k + 1]);
+  }
+  if (ss == 0.0) {
+    return;
+  }
+
+  // z = q s
+  for (int i = 0; i < rows; i++) {
+    const double *q = &Q(i, 0);
+    double sum = 0.0;
+    for (int k = 0; k < rows; k++) {
+      sum += q[k] * p_step[k + 1];
+    }
+    m_z[i] = sum;
+  }
+
+  // v = (H(new) - H(old) - R^T z) / (s^T s), using m_w for storage
+  double *v = &m_w[0];
+  for (int j = 0; j < cols; j++) {
+    v[j] = p_newLHS[j + 1] - p_oldLHS[j + 1];
+  }
+  for (int i = 0; i < cols; i++) {
+    const double *r = &R(i, 0);
+    for (int j = i; j < cols; j++) {
+      v[j] -= r[j] * m_z[i];
+    }
+  }
+  for (int j = 0; j < cols; j++) {
+    v[j] /= ss;
+  }
+
+  for (int k = rows - 1; k >= 1; k--) {
+    Rotate(k - 1, k, m_z[k - 1], m_z[k], k - 1);
+  }
+  for (int j = 0; j < cols; j++) {
+    R(0, j) += m_z[0] * v[j];
+  }
+  for (int k = 0; k < cols; k++) {
+    Rotate(k, k + 1, R(k, k), R(k + 1, k), k + 1);
+  }
+}
+
+void PathQR::NewtonStep(Vector<double> &p_point, const Vector<double> &p_lhs,
+			Vector<double> &p_step, double &p_dist)
+{
+  const int rows = m_rows, cols = m_cols;
+
+  // Solve R^T z = H by forward substitution, by rows of R
+  for (int k = 0; k < cols; k++) {
+    m_z[k] = p_lhs[k + 1];
+  }
+  for (int l = 0; l < cols; l++) {
+    const double *r = &R(l, 0);
+    m_z[l] /= r[l];
+    for (int k = l + 1; k < cols; k++) {
+      m_z[k] -= r[k] * m_z[l];
+    }
+  }
+
+  // The step is -q^T z
+  for (int k = 1; k <= rows; k++) {
+    p_step[k] = 0.0;
+  }
+  for (int l = 0; l < cols; l++) {
+    const double *q = &Q(l, 0);
+    for (int k = 0; k < rows; k++) {
+      p_step[k + 1] -= q[k] * m_z[l];
+    }
+  }
+
+  p_dist = 0.0;
+  for (int k = 1; k <= rows; k++) {
+    p_point[k] += p_step[k];
+    p_dist += sqr(p_step[k]);
+  }
+  p_dist = sqrt(p_dist);
+}
+
+void PathQR::GetTangent(Vector<double> &p_tangent) const
+{
+  const double *q = &m_q[(m_rows - 1) * m_rows];
+  for (int k = 0; k < m_rows; k++) {
+    p_tangent[k + 1] = q[k];
+  }
+}
+
+//----------------------------------------------------------------------------
+//          SparsePathSolver: LU factorization of augmented Jacobian
+//----------------------------------------------------------------------------
+
+void SparsePathSolver::SetJacobian(const SparseJacobian &p_jacobian,
+				   const Vector<double> &p_tangent)
+{
+  const int n = p_jacobian.NumColumns();
+  const int rows = p_jacobian.NumRows();
+  m_size = n;
+
+  // Transpose J into column form, appending the tangent as the last row
+  m_ap.assign(n + 1, 0);
+  for (int p = 0; p < p_jacobian.RowStart(rows); p++) {
+    m_ap[p_jacobian.GetIndex(p) + 1]++;
+  }
+  for (int j = 0; j < n; j++) {
+    m_ap[j + 1] += m_ap[j] + ((p_tangent[j + 1] != 0.0) ? 1 : 0);
+  }
+  m_ai.resize(m_ap[n]);
+  m_ax.resize(m_ap[n]);
+  std::vector<int> &next = m_stack;
+  next.assign(m_ap.begin(), m_ap.end() - 1);
+  for (int i = 0; i < rows; i++) {
+    for (int p = p_jacobian.RowStart(i); p < p_jacobian.RowStart(i + 1); p++) {
+      int q = next[p_jacobian.GetIndex(p)]++;
+      m_ai[q] = i;
+      m_ax[q] = p_jacobian.GetValue(p);
+    }
+  }
+  for (int j = 0; j < n; j++) {
+    if (p_tangent[j + 1] != 0.0) {
+      int q = next[j]++;
+      m_ai[q] = rows;
+      m_ax[q] = p_tangent[j + 1];
+    }
   }
-  double s1 = c1/sn;
-  double s2 = c2/sn;
 
-  for (int k = 1; k <= q.NumColumns(); k++) {
-    double sv1 = q(l1, k);
-    double sv2 = q(l2, k);
-    q(l1, k) = s1 * sv1 + s2 * sv2;
-    q(l2, k) = -s2 * sv1 + s1 * sv2;
+  Factor();
+
+  // The tangent solves A x = e_{N+1}
+  m_tangent.assign(n, 0.0);
+  m_tangent[n - 1] = 1.0;
+  Solve(m_tangent);
+  double norm = 0.0;
+  for (int k = 0; k < n; k++) {
+    norm += sqr(m_tangent[k]);
+  }
+  norm = sqrt(norm);
+  for (int k = 0; k < n; k++) {
+    m_tangent[k] /= norm;
   }
+}
 
-  for (int k = l3; k <= b.NumColumns(); k++) {
-    double sv1 = b(l1, k);
-    double sv2 = b(l2, k);
-    b(l1, k) = s1 * sv1 + s2 * sv2;
-    b(l2, k) = -s2 * sv1 + s1 * sv2;
+//
+// Finds the rows of L \ A(:,col) which can be nonzero, by depth-first
+// search from the nonzeros of the column through the graph of the columns
+// of L computed so far.  The rows are left in topological order in
+// m_stack[top..n-1], and the index top is returned.  m_stack[n..2n-1]
+// records the position reached in each column of L on the search path.
+//
+int SparsePathSolver::Reach(int p_col)
+{
+  const int n = m_size;
+  int top = n;
+  int *xi = &m_stack[0], *pstack = &m_stack[n];
+
+  for (int p = m_ap[p_col]; p < m_ap[p_col + 1]; p++) {
+    if (m_marked[m_ai[p]])  continue;
+    int head = 0;
+    xi[0] = m_ai[p];
+    while (head >= 0) {
+      int j = xi[head];
+      int jnew = m_pinv[j];
+      if (!m_marked[j]) {
+	m_marked[j] = 1;
+	pstack[head] = (jnew < 0) ? 0 : m_lp[jnew];
+      }
+      bool done = true;
+      int end = (jnew < 0) ? 0 : m_lp[jnew + 1];
+      for (int q = pstack[head]; q < end; q++) {
+	int i = m_li[q];
+	if (m_marked[i])  continue;
+	pstack[head] = q;
+	xi[++head] = i;
+	done = false;
+	break;
+      }
+      if (done) {
+	head--;
+	xi[--top] = j;
+      }
+    }
   }
 
-  c1 = sn;
-  c2 = 0.0;
+  for (int p = top; p < n; p++) {
+    m_marked[xi[p]] = 0;
+  }
+  return top;
 }
 
-static void QRDecomp(Matrix<double> &b, Matrix<double> &q)
+void SparsePathSolver::Factor(void)
 {
-  q.MakeIdent();
-  for (int m = 1; m <= b.NumColumns(); m++) {
-    for (int k = m + 1; k <= b.NumRows(); k++) {
-      Givens(b, q, b(m, m), b(k, m), m, k, m + 1);
+  const int n = m_size;
+  m_lp.resize(n + 1);
+  m_up.resize(n + 1);
+  m_li.clear();
+  m_lx.clear();
+  m_ui.clear();
+  m_ux.clear();
+  m_pinv.assign(n, -1);
+  m_stack.resize(2 * n);
+  m_marked.assign(n, 0);
+  m_x.assign(n, 0.0);
+
+  for (int k = 0; k < n; k++) {
+    m_lp[k] = m_li.size();
+    m_up[k] = m_ui.size();
+
+    // Sparse triangular solve x = L \ A(:,k), in the original row order
+    int top = Reach(k);
+    for (int p = m_ap[k]; p < m_ap[k + 1]; p++) {
+      m_x[m_ai[p]] = m_ax[p];
+    }
+    for (int px = top; px < n; px++) {
+      int j = m_stack[px];
+      int col = m_pinv[j];
+      if (col < 0)  continue;
+      // The unit diagonal of column col of L is its first entry
+      double xj = m_x[j];
+      for (int p = m_lp[col] + 1; p < m_lp[col + 1]; p++) {
+	m_x[m_li[p]] -= m_lx[p] * xj;
+      }
+    }
+
+    // Choose the largest entry in an unpivoted row as the pivot
+    int ipiv = -1;
+    double largest = -1.0;
+    for (int px = top; px < n; px++) {
+      int i = m_stack[px];
+      if (m_pinv[i] < 0) {
+	if (fabs(m_x[i]) > largest) {
+	  largest = fabs(m_x[i]);
+	  ipiv = i;
+	}
+      }
+      else {
+	m_ui.push_back(m_pinv[i]);
+	m_ux.push_back(m_x[i]);
+      }
+    }
+    if (ipiv < 0) {
+      // The column is structurally dependent on the previous ones; use
+      // any unpivoted row, as the dense factorization would, with a zero
+      // pivot
+      for (ipiv = 0; m_pinv[ipiv] >= 0; ipiv++);
+    }
+
+    double pivot = m_x[ipiv];
+    m_ui.push_back(k);
+    m_ux.push_back(pivot);
+    m_pinv[ipiv] = k;
+    m_li.push_back(ipiv);
+    m_lx.push_back(1.0);
+    for (int px = top; px < n; px++) {
+      int i = m_stack[px];
+      if (m_pinv[i] < 0) {
+	m_li.push_back(i);
+	m_lx.push_back(m_x[i] / pivot);
+      }
+      m_x[i] = 0.0;
     }
   }
+  m_lp[n] = m_li.size();
+  m_up[n] = m_ui.size();
+
+  // Express the row indices of L in pivot order
+  for (size_t p = 0; p < m_li.size(); p++) {
+    m_li[p] = m_pinv[m_li[p]];
+  }
 }
 
-static void NewtonStep(Matrix<double> &q, Matrix<double> &b,
-		       Vector<double> &u, Vector<double> &y,
-		       double &d)
+//
+// Solves A x = b, where p_x holds b on entry and x on exit.
+//
+void SparsePathSolver::Solve(std::vector<double> &p_x)
 {
-  for (int k = 1; k <= b.NumColumns(); k++) {
-    for (int l = 1; l <= k - 1; l++) {
-      y[k] -= b(l, k) * y[l];
+  const int n = m_size;
+  std::vector<double> &x = m_x;
+  for (int k = 0; k < n; k++) {
+    x[m_pinv[k]] = p_x[k];
+  }
+  for (int j = 0; j < n; j++) {
+    for (int p = m_lp[j] + 1; p < m_lp[j + 1]; p++) {
+      x[m_li[p]] -= m_lx[p] * x[j];
     }
-    y[k] /= b(k, k);
   }
+  for (int j = n - 1; j >= 0; j--) {
+    x[j] /= m_ux[m_up[j + 1] - 1];
+    for (int p = m_up[j]; p < m_up[j + 1] - 1; p++) {
+      x[m_ui[p]] -= m_ux[p] * x[j];
+    }
+  }
+  for (int k = 0; k < n; k++) {
+    p_x[k] = x[k];
+    x[k] = 0.0;
+  }
+}
 
-  d = 0.0;
-  for (int k = 1; k <= b.NumRows(); k++) {
-    double s = 0.0;
-    for (int l = 1; l <= b.NumColumns(); l++) {
-      s += q(l, k) * y[l];
+void SparsePathSolver::NewtonStep(Vector<double> &p_point,
+				  const Vector<double> &p_lhs,
+				  Vector<double> &p_step, double &p_dist)
+{
+  const int n = m_size;
+  std::vector<double> step(n);
+  for (int k = 0; k < n - 1; k++) {
+    step[k] = -p_lhs[k + 1];
+  }
+  step[n - 1] = 0.0;
+  Solve(step);
+
+  p_dist = 0.0;
+  for (int k = 0; k < n; k++) {
+    p_step[k + 1] = step[k];
+    p_point[k + 1] += step[k];
+    p_dist += sqr(step[k]);
+  }
+  p_dist = sqrt(p_dist);
+}
+
+void SparsePathSolver::GetTangent(Vector<double> &p_tangent) const
+{
+  for (int k = 0; k < m_size; k++) {
+    p_tangent[k + 1] = m_tangent[k];
+  }
+}
+
+//----------------------------------------------------------------------------
+//                  PathTracer: Linear algebra on the path
+//----------------------------------------------------------------------------
+
+void PathTracer::GetSparseJacobian(const Vector<double> &p_point,
+				   SparseJacobian &p_jacobian)
+{
+  const int n = p_point.Length();
+  if (m_jacobian.NumRows() != n || m_jacobian.NumColumns() != n - 1) {
+    m_jacobian = Matrix<double>(n, n - 1);
+  }
+  GetJacobian(p_point, m_jacobian);
+  p_jacobian.Clear(n);
+  for (int j = 1; j < n; j++) {
+    for (int i = 1; i <= n; i++) {
+      if (m_jacobian(i, j) != 0.0) {
+	p_jacobian.AddEntry(i, m_jacobian(i, j));
+      }
+    }
+    p_jacobian.EndRow();
+  }
+}
+
+void PathTracer::Linearize(const Vector<double> &p_point,
+			   const Vector<double> &p_tangent)
+{
+  if (m_sparse) {
+    GetSparseJacobian(p_point, m_sparseJacobian);
+    m_sparseSolver.SetJacobian(m_sparseJacobian, p_tangent);
+  }
+  else {
+    const int n = p_point.Length();
+    if (m_jacobian.NumRows() != n || m_jacobian.NumColumns() != n - 1) {
+      m_jacobian = Matrix<double>(n, n - 1);
     }
-    u[k] -= s;
-    d += s * s;
+    GetJacobian(p_point, m_jacobian);
+    m_qr.Factor(m_jacobian);
   }
-  d = sqrt(d);
 }
 
+void PathTracer::NewtonStep(Vector<double> &p_point,
+			    const Vector<double> &p_lhs,
+			    Vector<double> &p_step, double &p_dist)
+{
+  if (m_sparse) {
+    m_sparseSolver.NewtonStep(p_point, p_lhs, p_step, p_dist);
+  }
+  else {
+    m_qr.NewtonStep(p_point, p_lhs, p_step, p_dist);
+  }
+}
+
+void PathTracer::GetTangent(Vector<double> &p_tangent) const
+{
+  if (m_sparse) {
+    m_sparseSolver.GetTangent(p_tangent);
+  }
+  else {
+    m_qr.GetTangent(p_tangent);
+  }
+}
 
 //----------------------------------------------------------------------------
 //             PathTracer: Implementation of path-following engine
@@ -127,14 +539,18 @@ PathTracer::TracePath(Vector<double> &x,
   Vector<double> u(x.Length()), restart(x.Length());
   // t is current tangent at x; newT is tangent at u, which is the next point.
   Vector<double> t(x.Length()), newT(x.Length());
-  Vector<double> y(x.Length() - 1);
-  Matrix<double> b(x.Length(), x.Length() - 1);
-  SquareMatrix<double> q(x.Length());
+  // y is the value of the system at u, and yOld at the previous corrector
+  // iterate; step is the last corrector step
+  Vector<double> y(x.Length() - 1), yOld(x.Length() - 1);
+  Vector<double> step(x.Length());
 
   OnStep(x, false);
-  GetJacobian(x, b);
-  QRDecomp(b, q);
-  q.GetRow(q.NumRows(), t);
+  // Absent a previous tangent, the sparse solver orients the path
+  // towards increasing lambda
+  t = 0.0;
+  t[t.Length()] = 1.0;
+  Linearize(x, t);
+  GetTangent(t);
   
   while (x[x.Length()] >= 0.0 && x[x.Length()] < p_maxLambda) {
     bool accept = true;
@@ -153,8 +569,7 @@ PathTracer::TracePath(Vector<double> &x,
     }
 
     double decel = 1.0 / m_maxDecel;  // initialize deceleration factor
-    GetJacobian(u, b);
-    QRDecomp(b, q);
+    Linearize(u, t);
 
     int iter = 1;
     double disto = 0.0;
@@ -162,7 +577,12 @@ PathTracer::TracePath(Vector<double> &x,
       double dist;
 
       GetLHS(u, y);
-      NewtonStep(q, b, u, y, dist); 
+      if (iter >= 2 && !m_sparse) {
+	// Broyden update of the Jacobian along the last corrector step
+	m_qr.Update(step, yOld, y);
+      }
+      yOld = y;
+      NewtonStep(u, y, step, dist);
 
       if (dist >= c_maxDist) {
 	accept = false;
@@ -215,7 +635,7 @@ PathTracer::TracePath(Vector<double> &x,
     }
 
     // Obtain the tangent at the next step
-    q.GetRow(q.NumRows(), newT); 
+    GetTangent(newT);
 
     if (!newton &&
 	Criterion(x, t) * Criterion(u, newT) < 0.0) {
@@ -23,8 +23,122 @@
 #ifndef PATH_H
 #define PATH_H
 
+#include <vector>
+
 using namespace Gambit;
 
+//
+// The QR factorization q B = R of the transposed Jacobian B of the
+// system defining the path, where B has N+1 rows and N columns, q is
+// orthogonal, and R is upper triangular with nonnegative diagonal.  The
+// last row of q is then the tangent to the path, oriented so that the
+// determinant of [B t] is positive.  The factors are kept in contiguous
+// row-major arrays, which are reused as long as the dimension is unchanged.
+//
+class PathQR {
+public:
+  PathQR(void) : m_rows(0), m_cols(0) { }
+
+  // Compute the factorization of the matrix from scratch.
+  void Factor(const Matrix<double> &p_matrix);
+  // Update the factorization by Broyden's rank-one formula, given a step
+  // and the values of the system before and after the step.
+  void Update(const Vector<double> &p_step,
+	      const Vector<double> &p_oldLHS, const Vector<double> &p_newLHS);
+
+  // Take the Newton step from p_point for a system with value p_lhs,
+  // returning the step taken and its length.
+  void NewtonStep(Vector<double> &p_point, const Vector<double> &p_lhs,
+		  Vector<double> &p_step, double &p_dist);
+  // Get the tangent to the path
+  void GetTangent(Vector<double> &p_tangent) const;
+
+private:
+  int m_rows, m_cols;
+  // The factors, and scratch space for the Broyden update
+  std::vector<double> m_r, m_q, m_w, m_z;
+
+  double &R(int i, int j) { return m_r[i * m_cols + j]; }
+  double &Q(int i, int j) { return m_q[i * m_rows + j]; }
+
+  void Resize(int p_rows, int p_cols);
+  void Rotate(int p_row1, int p_row2, double &p_c1, double &p_c2, int p_col);
+};
+
+//
+// A sparse Jacobian of the system defining the path, in compressed sparse
+// row form, with one row per equation and one column per coordinate of
+// the point.  Rows are built one at a time by adding entries and then
+// ending the row.
+//
+class SparseJacobian {
+public:
+  SparseJacobian(void) : m_cols(0) { }
+
+  // Remove all rows, setting the number of columns
+  void Clear(int p_cols)
+  { m_cols = p_cols; m_rowStart.assign(1, 0); m_index.clear(); m_values.clear(); }
+  // Add the entry in (one-based) column p_col to the current row
+  void AddEntry(int p_col, double p_value)
+  { m_index.push_back(p_col - 1); m_values.push_back(p_value); }
+  // Finish the current row
+  void EndRow(void) { m_rowStart.push_back(m_index.size()); }
+
+  int NumRows(void) const { return m_rowStart.size() - 1; }
+  int NumColumns(void) const { return m_cols; }
+
+  // Entries of row i are at positions RowStart(i) to RowStart(i+1)-1
+  int RowStart(int i) const { return m_rowStart[i]; }
+  // Zero-based column and value of the entry at a position
+  int GetIndex(int p) const { return m_index[p]; }
+  double GetValue(int p) const { return m_values[p]; }
+
+private:
+  int m_cols;
+  std::vector<int> m_rowStart, m_index;
+  std::vector<double> m_values;
+};
+
+//
+// Solves the linear systems of the path tracer using a sparse Jacobian J,
+// by a sparse LU factorization with partial pivoting of the square matrix
+// A obtained by appending to J the previous tangent t as a last row.  The
+// tangent at the point solves A x = e_{N+1}, so it keeps the orientation
+// of t, and the Newton step solves A s = (-H, 0), so it is orthogonal to t.
+// The factorization is computed column by column, each column by a sparse
+// triangular solve with the columns of L already computed.
+//
+class SparsePathSolver {
+public:
+  SparsePathSolver(void) : m_size(0) { }
+
+  // Set the Jacobian, with an approximation to the tangent at the point
+  void SetJacobian(const SparseJacobian &p_jacobian,
+		   const Vector<double> &p_tangent);
+
+  // Take the Newton step from p_point for a system with value p_lhs,
+  // returning the step taken and its length.
+  void NewtonStep(Vector<double> &p_point, const Vector<double> &p_lhs,
+		  Vector<double> &p_step, double &p_dist);
+  // Get the tangent to the path
+  void GetTangent(Vector<double> &p_tangent) const;
+
+private:
+  int m_size;
+  // The augmented matrix, and its factors, in compressed sparse column form
+  std::vector<int> m_ap, m_ai, m_lp, m_li, m_up, m_ui;
+  std::vector<double> m_ax, m_lx, m_ux;
+  // Row permutation: row i of A is the pivot of column m_pinv[i]
+  std::vector<int> m_pinv;
+  // Scratch space for the factorization and solves
+  std::vector<int> m_stack, m_marked;
+  std::vector<double> m_x, m_tangent;
+
+  void Factor(void);
+  int Reach(int p_col);
+  void Solve(std::vector<double> &p_x);
+};
+
 //
 // This class implements a generic path-following algorithm for smooth curves.
 // It is based on the ideas and codes presented in Allgower and Georg's
@@ -41,8 +155,14 @@ public:
   void SetTargetParam(double p_targetParam) { m_targetParam = p_targetParam; }
   double GetTargetParam(void) const { return m_targetParam; }
 
+  // Use sparse Jacobians, with a sparse LU factorization of the Jacobian
+  // augmented by the tangent, instead of dense QR
+  void SetSparse(bool p_sparse) { m_sparse = p_sparse; }
+  bool IsSparse(void) const { return m_sparse; }
+
 protected:
-  PathTracer(void) : m_maxDecel(1.1), m_hStart(0.03), m_targetParam(0.0) 
+  PathTracer(void) : m_maxDecel(1.1), m_hStart(0.03), m_targetParam(0.0),
+		     m_sparse(false)
     { } 
   virtual ~PathTracer() { }
 
@@ -59,9 +179,26 @@ protected:
   virtual void GetLHS(const Vector<double> &p_point, Vector<double> &p_lhs) = 0;
   // Compute the Jacobian matrix at the specified point.
   virtual void GetJacobian(const Vector<double> &p_point, Matrix<double> &p_matrix) = 0;
+  // Compute the Jacobian in sparse form, with one row per equation.
+  // The default implementation compresses the dense Jacobian.
+  virtual void GetSparseJacobian(const Vector<double> &p_point,
+				 SparseJacobian &p_jacobian);
 
 private:
   double m_maxDecel, m_hStart, m_targetParam;
+  bool m_sparse;
+  // Workspace for the Jacobian and its factorization
+  Matrix<double> m_jacobian;
+  PathQR m_qr;
+  SparseJacobian m_sparseJacobian;
+  SparsePathSolver m_sparseSolver;
+
+  // Evaluate the Jacobian at the point and prepare to solve with it,
+  // given an approximation to the tangent at the point
+  void Linearize(const Vector<double> &p_point, const Vector<double> &p_tangent);
+  void NewtonStep(Vector<double> &p_point, const Vector<double> &p_lhs,
+		  Vector<double> &p_step, double &p_dist);
+  void GetTangent(Vector<double> &p_tangent) const;
 };
 
 #endif  // PATH_H
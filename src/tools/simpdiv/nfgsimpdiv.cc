@@ -23,11 +23,17 @@
 #include <unistd.h>
 #include <getopt.h>
 #include <cstdlib>
+#include <climits>
 #include <iostream>
 #include <cerrno>
 #include <iomanip>
 #include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
 #include "libgambit/libgambit.h"
+#include "libgambit/multistart.h"
 
 //
 // simpdiv is a simplicial subdivision algorithm with restart, for finding
@@ -55,6 +61,10 @@
 //
 // -g #:  Multiplier for grid restart (default is 2)
 //
+// -j #:  Number of threads on which to run the starting points
+//
+// -u:  Report each distinct equilibrium only once
+//
 // 
 // Some history:
 // 
@@ -104,7 +114,8 @@ public:
   int LeashLength(void) const { return m_leashLength; }
   void SetLeashLength(int p_leashLength) { m_leashLength = p_leashLength; }
 
-  void Solve(const Gambit::Game &, const Gambit::MixedStrategyProfile<Gambit::Rational> &);
+  void Solve(const Gambit::Game &, const Gambit::MixedStrategyProfile<Gambit::Rational> &,
+	     Gambit::MultiStartOutput &);
 };
 
 
@@ -529,7 +540,8 @@ Gambit::Integer find_lcd(const Gambit::Vector<Gambit::Rational> &vec)
 }
 
 void nfgSimpdiv::Solve(const Gambit::Game &p_nfg, 
-		       const Gambit::MixedStrategyProfile<Gambit::Rational> &p_start)
+		       const Gambit::MixedStrategyProfile<Gambit::Rational> &p_start,
+		       Gambit::MultiStartOutput &p_output)
 {
   // A raft of initializations moved here from the former constructor.
   // This algorithm is in need of some serious reorganization!
@@ -546,7 +558,7 @@ void nfgSimpdiv::Solve(const Gambit::Game &p_nfg,
     
   Gambit::MixedStrategyProfile<Gambit::Rational> y(p_start);
   if (g_verbose) {
-    PrintProfile(std::cout, "start", y);
+    PrintProfile(p_output.GetStream(), "start", y);
   }
 
   while (true) {
@@ -555,12 +567,71 @@ void nfgSimpdiv::Solve(const Gambit::Game &p_nfg,
     maxz = Simplex(y);
     
     if (g_verbose) {
-      PrintProfile(std::cout, Gambit::lexical_cast<std::string>(d), y);
+      PrintProfile(p_output.GetStream(), Gambit::lexical_cast<std::string>(d), y);
     }
     if (maxz < Gambit::Rational(TOL)) break;
   }
     
-  PrintProfile(std::cout, "NE", y);
+  std::ostringstream text;
+  PrintProfile(text, "NE", y);
+  std::vector<double> profile(y.MixedProfileLength());
+  for (int i = 1; i <= y.MixedProfileLength(); i++) {
+    profile[i - 1] = (double) y[i];
+  }
+  p_output.AddEquilibrium(profile, text.str());
+}
+
+//-------------------------------------------------------------------------
+//                        class nfgSimpdivWorker
+//-------------------------------------------------------------------------
+
+class nfgSimpdivWorker : public Gambit::MultiStartWorker {
+private:
+  Gambit::Game m_game;
+  const Gambit::List<Gambit::Vector<Gambit::Rational> > *m_starts;
+
+public:
+  nfgSimpdivWorker(const Gambit::Game &p_game,
+		   const Gambit::List<Gambit::Vector<Gambit::Rational> > &p_starts)
+    : m_game(p_game), m_starts(&p_starts) { }
+  virtual ~nfgSimpdivWorker() { }
+
+  void Run(int p_start, Gambit::MultiStartOutput &p_output);
+};
+
+void nfgSimpdivWorker::Run(int p_start, Gambit::MultiStartOutput &p_output)
+{
+  Gambit::MixedStrategyProfile<Gambit::Rational> start(m_game->NewMixedStrategyProfile(Gambit::Rational(0)));
+  ((Gambit::Vector<Gambit::Rational> &) start) = (*m_starts)[p_start + 1];
+
+  nfgSimpdiv algorithm;
+  algorithm.Solve(m_game, start, p_output);
+}
+
+//
+// Runs the algorithm from each of the starting points.  Each worker after
+// the first solves on its own copy of the game.
+//
+void Solve(const Gambit::Game &p_game,
+	   const Gambit::List<Gambit::Vector<Gambit::Rational> > &p_starts,
+	   int p_numThreads, bool p_unique)
+{
+  int numThreads = std::max(1, std::min(p_numThreads, p_starts.Length()));
+  std::vector<nfgSimpdivWorker> workers;
+  for (int i = 0; i < numThreads; i++) {
+    Gambit::Game game = p_game;
+    if (i > 0) {
+      game = p_game->Copy();
+    }
+    workers.push_back(nfgSimpdivWorker(game, p_starts));
+  }
+
+  std::vector<Gambit::MultiStartWorker *> pointers;
+  for (int i = 0; i < numThreads; i++) {
+    pointers.push_back(&workers[i]);
+  }
+  Gambit::MultiStartRunner runner(std::cout, p_unique);
+  runner.Run(p_starts.Length(), pointers);
 }
 
 void Randomize(Gambit::MixedStrategyProfile<Gambit::Rational> &p_profile, int p_denom)
@@ -604,10 +675,12 @@ void PrintHelp(char *progname)
   std::cerr << "                   (default is to show as rational numbers)\n";
   std::cerr << "  -g MULT          granularity of grid refinement at each step (default is 2)\n";
   std::cerr << "  -h, --help       print this help message\n";
+  std::cerr << "  -j THREADS       number of threads to run starting points on (default 1)\n";
   std::cerr << "  -r DENOM         generate random starting points with denominator DENOM\n";
   std::cerr << "  -n COUNT         number of starting points to generate (requires -r)\n";
   std::cerr << "  -s FILE          file containing starting points\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
+  std::cerr << "  -u               report each distinct equilibrium only once\n";
   std::cerr << "  -V, --verbose    verbose mode (shows intermediate output)\n";
   std::cerr << "  -v, --version    print version information\n";
   std::cerr << "                   (default is to only show equilibria)\n";
@@ -619,8 +692,8 @@ int main(int argc, char *argv[])
   opterr = 0;
   std::string startFile;
   bool useRandom = false;
-  int randDenom = 1, stopAfter = 1;
-  bool quiet = false;
+  int randDenom = 1, stopAfter = 1, numThreads = 1;
+  bool quiet = false, unique = false;
 
   int long_opt_index = 0;
   struct option long_options[] = {
@@ -630,7 +703,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "g:hVvn:r:s:d:qS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "g:hVvn:r:s:d:qSj:u", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -654,6 +727,19 @@ int main(int argc, char *argv[])
     case 's':
       startFile = optarg;
       break;
+    case 'j': {
+      char *end;
+      long threads = strtol(optarg, &end, 10);
+      if (end == optarg || *end != '\0' || threads < 1 || threads > INT_MAX) {
+	std::cerr << argv[0] << ": Number of threads must be a positive integer.\n";
+	PrintHelp(argv[0]);
+      }
+      numThreads = (int) threads;
+      break;
+    }
+    case 'u':
+      unique = true;
+      break;
     case 'q':
       quiet = true;
       break;
@@ -694,15 +780,20 @@ int main(int argc, char *argv[])
 
   try {
     Gambit::Game game = Gambit::ReadGame(*input_stream);
+    // Each pivot evaluates payoffs against a mixed profile, which reads
+    // the dense payoff table in one pass instead of visiting outcomes
+    game->SetCompactPayoffs(true);
 
+    // Starting points are all chosen before any are run, so the sequence
+    // of random numbers, and the output, do not depend on the threads
+    Gambit::List<Gambit::Vector<Gambit::Rational> > starts;
     if (startFile != "") {
       std::ifstream startPoints(startFile.c_str());
       
       while (!startPoints.eof() && !startPoints.bad()) {
 	Gambit::MixedStrategyProfile<Gambit::Rational> start(game->NewMixedStrategyProfile(Gambit::Rational(0)));
 	if (ReadProfile(startPoints, start)) {
-	  nfgSimpdiv algorithm;
-	  algorithm.Solve(game, start);
+	  starts.Append((const Gambit::Vector<Gambit::Rational> &) start);
 	}
       }
     }
@@ -710,9 +801,7 @@ int main(int argc, char *argv[])
       for (int i = 1; i <= stopAfter; i++) {
 	Gambit::MixedStrategyProfile<Gambit::Rational> start(game->NewMixedStrategyProfile(Gambit::Rational(0)));
 	Randomize(start, randDenom);
-	
-	nfgSimpdiv algorithm;
-	algorithm.Solve(game, start);
+	starts.Append((const Gambit::Vector<Gambit::Rational> &) start);
       }
     }
     else {
@@ -724,10 +813,10 @@ int main(int argc, char *argv[])
 	  start[start.GetSupport().GetStrategy(pl, st)] = Gambit::Rational(0);
 	}
       }
-      
-      nfgSimpdiv algorithm;
-      algorithm.Solve(game, start);
+      starts.Append((const Gambit::Vector<Gambit::Rational> &) start);
     }
+
+    Solve(game, starts, numThreads, unique);
    
     return 0;
   }
@@ -736,6 +825,10 @@ int main(int argc, char *argv[])
     if (g_verbose) std::cerr<<e.what()<<endl;
     return 1;
   }
+  catch (std::runtime_error &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
   catch (...) {
     std::cerr << "Error: An internal error occurred.\n";
     return 1;